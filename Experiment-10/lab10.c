@@ -1,13 +1,124 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+#define AC_MAX_DENSE_CELLS (1 << 18)  // Cap on dense row entries (1 MB) so the hot table fits in L2
+#define SEARCH_CHUNK_SIZE (4u << 20)  // Bytes of new text per chunk in the chunked search driver
+
+// Aho-Corasick state. Nodes are numbered in BFS order, so the shallow, hot states are contiguous.
+typedef struct {
+    int fail;         // Longest proper suffix that is also a trie node
+    int pattern;      // Pattern ending exactly here (-1 if none)
+} ACNode;
+
+// Complete transitions of a state without a dense row, stored as the byte classes whose target
+// differs from the root row's: bit k of bits is set for those, and their targets are packed in
+// class order from sparse_targets[start]; before[w] counts the set bits in words below w.
+typedef struct {
+    uint64_t bits[4];
+    int start;
+    uint16_t before[4];
+} ACSparseRow;
+
+// Automaton built once from a pattern set
+typedef struct {
+    ACNode *nodes;
+    int node_count;
+    uint8_t byte_class[256];   // Bytes of the patterns get classes 0..; all other bytes share the last
+    int class_count;
+    int dense_count;           // States below this index have a dense row (row number == state)
+    int *dense_rows;           // dense_rows[state * class_count + k]: complete transition for class k
+    ACSparseRow *sparse_rows;  // sparse_rows[state - dense_count] for the other states
+    int *sparse_targets;
+    int *output;               // Nearest state on the fail chain (itself included) ending a pattern, or -1
+    int *same_pattern;         // Next pattern id with the same text (duplicates), or -1
+    int *pattern_length;
+    int pattern_count;
+} AhoCorasick;
+
+// Where the matchers record match positions while the chunked driver runs them. Outside the
+// driver match_sink is NULL and the matchers only count.
+typedef struct {
+    size_t base;          // File offset of text[0] in the string being searched
+    size_t *offsets;
+    size_t count, capacity, limit;
+} MatchSink;
+
+static _Thread_local MatchSink *match_sink;
+
+static inline void record_match(int position) {
+    MatchSink *sink = match_sink;
+    if (!sink || sink->count >= sink->limit)
+        return;
+    if (sink->count == sink->capacity) {
+        sink->capacity = sink->capacity ? sink->capacity * 2 : 64;
+        sink->offsets = realloc(sink->offsets, sink->capacity * sizeof(size_t));
+    }
+    sink->offsets[sink->count++] = sink->base + position;
+}
+
+// Rabin-Karp counters: every window whose hash equals a pattern hash is a hit, and a hit that
+// fails the byte-by-byte verification is spurious. Thread-local so the chunked driver can run
+// the matchers on several threads.
+typedef struct {
+    long long windows;
+    long long hash_hits;
+    long long spurious_hits;
+    long long matches;
+} RabinKarpStats;
+
+static _Thread_local RabinKarpStats rk_stats;
+
+typedef void (*MatchFunc)(const char *text, const char *pattern, int *match_count);
+
+// Totals from the chunked search driver
+typedef struct {
+    long long count;       // Every occurrence, even past the offset limit
+    size_t *offsets;       // First offsets in file order (at most the requested limit)
+    size_t offset_count;
+    size_t bytes;
+    double seconds;
+} SearchResult;
 
 // Function prototypes
 void naive_string_match(const char *text, const char *pattern, int *match_count);
+void simd_string_match(const char *text, const char *pattern, int *match_count);
+const char *simd_search_name(void);
 void rabin_karp(const char *text, const char *pattern, int *match_count);
+void rabin_karp64(const char *text, const char *pattern, int *match_count);
+long long rabin_karp_multi(const char *text, size_t n, const char *patterns[], int count, long long *counts);
 void KMPSearch(const char *text, const char *pattern, int *match_count);
 void computeLPSArray(const char *pattern, int m, int *lps);
+void horspool_search(const char *text, const char *pattern, int *match_count);
+void two_way_search(const char *text, const char *pattern, int *match_count);
+void auto_string_match(const char *text, const char *pattern, int *match_count);
+MatchFunc select_search_algorithm(size_t n, size_t m, int alphabet_size);
+void calibrate_selector(int verbose);
+void benchmark_text_index(void);
+double measure_time(void (*func)(const char*, const char*, int*), const char *text, const char *pattern, int *match_count, int repeats);
+AhoCorasick *ac_build(const char *patterns[], int count);
+long long ac_search(const AhoCorasick *ac, const char *text, size_t n,
+                    void (*report)(int pattern, size_t offset, void *context), void *context);
+void ac_free(AhoCorasick *ac);
+void benchmark_multi_pattern(void);
+void benchmark_simd_search(void);
+int search_mapped_file(int fd, const char *pattern, MatchFunc func, int threads, size_t max_offsets, SearchResult *result);
+int search_stream(FILE *in, const char *pattern, MatchFunc func, int threads, size_t max_offsets, SearchResult *result);
+void benchmark_chunked_search(void);
+void benchmark_rolling_hash(void);
 
 // Naive String Matching Algorithm
 void naive_string_match(const char *text, const char *pattern, int *match_count) {
@@ -23,8 +134,115 @@ void naive_string_match(const char *text, const char *pattern, int *match_count)
         }
         if (j == m) {
             (*match_count)++;  // Increment match count if pattern is found
+            record_match(i);
+        }
+    }
+}
+
+// ==================== SIMD naive search ====================
+// Each vector step compares the pattern's first byte against text[i .. i+W-1] and its last byte
+// against text[i+m-1 .. i+m-1+W-1]; only positions where both agree are checked with memcmp.
+// Positions too close to the end for a full vector load are finished by the scalar loop.
+
+// Function to count matches at positions [from, n - m] one byte at a time
+static int scalar_match_from(const char *text, int n, const char *pattern, int m, int from) {
+    int count = 0;
+    for (int i = from; i <= n - m; i++)
+        if (text[i] == pattern[0] && memcmp(text + i + 1, pattern + 1, m - 1) == 0) {
+            count++;
+            record_match(i);
+        }
+    return count;
+}
+
+#ifdef HAVE_X86_SIMD
+// Function to verify the candidates in a bitmask (bit k = position i + k)
+static inline int verify_candidates(unsigned mask, const char *text, int i, const char *pattern, int m) {
+    int count = 0;
+    while (mask) {
+        int k = __builtin_ctz(mask);
+        if (m <= 2 || memcmp(text + i + k + 1, pattern + 1, m - 2) == 0) {
+            count++;
+            record_match(i + k);
         }
+        mask &= mask - 1;
     }
+    return count;
+}
+
+// SSE2 version: 16 positions per step (SSE2 is part of every x86-64 CPU)
+__attribute__((target("sse2")))
+static int sse2_match(const char *text, int n, const char *pattern, int m) {
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+    int count = 0, i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(text + i + m - 1));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last));
+        count += verify_candidates((unsigned)_mm_movemask_epi8(eq), text, i, pattern, m);
+    }
+    return count + scalar_match_from(text, n, pattern, m, i);
+}
+
+// AVX2 version: 32 positions per step
+__attribute__((target("avx2")))
+static int avx2_match(const char *text, int n, const char *pattern, int m) {
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[m - 1]);
+    int count = 0, i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *)(text + i + m - 1));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last));
+        count += verify_candidates((unsigned)_mm256_movemask_epi8(eq), text, i, pattern, m);
+    }
+    return count + scalar_match_from(text, n, pattern, m, i);
+}
+#endif
+
+static int scalar_match(const char *text, int n, const char *pattern, int m) {
+    return scalar_match_from(text, n, pattern, m, 0);
+}
+
+// Selected on first use from what the CPU supports
+static int (*simd_match_impl)(const char *, int, const char *, int);
+static const char *simd_match_name;
+
+static void select_simd_match(void) {
+    simd_match_impl = scalar_match;
+    simd_match_name = "scalar";
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        simd_match_impl = avx2_match;
+        simd_match_name = "AVX2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        simd_match_impl = sse2_match;
+        simd_match_name = "SSE2";
+    }
+#endif
+}
+
+// Function to report which implementation simd_string_match uses on this CPU
+const char *simd_search_name(void) {
+    if (!simd_match_impl)
+        select_simd_match();
+    return simd_match_name;
+}
+
+// SIMD Naive String Matching: same result as naive_string_match, same signature for measure_time
+void simd_string_match(const char *text, const char *pattern, int *match_count) {
+    int n = strlen(text);
+    int m = strlen(pattern);
+
+    if (m == 0 || m > n) {
+        naive_string_match(text, pattern, match_count);
+        return;
+    }
+    if (!simd_match_impl)
+        select_simd_match();
+    *match_count += simd_match_impl(text, n, pattern, m);
 }
 
 // Rabin-Karp Algorithm
@@ -42,16 +260,19 @@ void rabin_karp(const char *text, const char *pattern, int *match_count) {
         h = (h * d) % q;
     }
 
-    // Calculate the hash value of pattern and first window of text
+    // Calculate the hash value of pattern and first window of text. Bytes are hashed as unsigned
+    // char, so non-ASCII bytes do not make the hashes negative
     for (int i = 0; i < m; i++) {
-        p = (d * p + pattern[i]) % q;
-        t = (d * t + text[i]) % q;
+        p = (d * p + (unsigned char)pattern[i]) % q;
+        t = (d * t + (unsigned char)text[i]) % q;
     }
 
     // Slide the pattern over text one by one
+    rk_stats.windows += n >= m ? n - m + 1 : 0;
     for (int i = 0; i <= n - m; i++) {
         // Check the hash values of current window of text and pattern
         if (p == t) {
+            rk_stats.hash_hits++;
             // Check for characters one by one
             int j;
             for (j = 0; j < m; j++) {
@@ -61,12 +282,16 @@ void rabin_karp(const char *text, const char *pattern, int *match_count) {
             }
             if (j == m) {
                 (*match_count)++;  // Increment match count if pattern is found
+                rk_stats.matches++;
+                record_match(i);
+            } else {
+                rk_stats.spurious_hits++;
             }
         }
 
         // Calculate hash value for next window of text: Remove leading digit, add trailing digit
         if (i < n - m) {
-            t = (d * (t - text[i] * h) + text[i + m]) % q;
+            t = (d * (t - (unsigned char)text[i] * h) + (unsigned char)text[i + m]) % q;
 
             // We might get negative value of t, converting it to positive
             if (t < 0) {
@@ -76,6 +301,131 @@ void rabin_karp(const char *text, const char *pattern, int *match_count) {
     }
 }
 
+// ==================== 64-bit rolling hash ====================
+// Polynomial hash modulo 2^64 with an odd base: the wraparound of unsigned arithmetic is the
+// modulus, so rolling one byte is a multiply, an add and a table lookup, with no division. Two
+// different m-byte strings collide about once in 2^64 for ordinary text; the known bad case for
+// this modulus (Thue-Morse strings) needs patterns of 2048+ bytes, and a collision would only cost
+// a failed memcmp, which the spurious-hit counter reports.
+#define RK_BASE 0x9e3779b97f4a7c15ull
+
+// Function to hash the m bytes at s
+static uint64_t rk_hash(const char *s, size_t m) {
+    uint64_t h = 0;
+    for (size_t i = 0; i < m; i++)
+        h = h * RK_BASE + (uint8_t)s[i];
+    return h;
+}
+
+// Function to fill drop[c] = c * BASE^m, the term a byte contributes when it leaves an m-byte window
+static void rk_drop_table(size_t m, uint64_t drop[256]) {
+    uint64_t weight = 1;
+    for (size_t i = 0; i < m; i++)
+        weight *= RK_BASE;
+    for (int c = 0; c < 256; c++)
+        drop[c] = c * weight;
+}
+
+// Function to slide the window hash one byte: drop `out`, append `in`
+static inline uint64_t rk_roll(uint64_t h, uint8_t out, uint8_t in, const uint64_t drop[256]) {
+    return h * RK_BASE + in - drop[out];
+}
+
+// Rabin-Karp with the 64-bit rolling hash; same interface as rabin_karp
+void rabin_karp64(const char *text, const char *pattern, int *match_count) {
+    size_t n = strlen(text), m = strlen(pattern);
+    if (m == 0 || m > n) {
+        naive_string_match(text, pattern, match_count);
+        return;
+    }
+    uint64_t drop[256];
+    rk_drop_table(m, drop);
+
+    uint64_t p = rk_hash(pattern, m), t = rk_hash(text, m);
+    rk_stats.windows += n - m + 1;
+    for (size_t i = 0;; i++) {
+        if (p == t) {
+            rk_stats.hash_hits++;
+            if (memcmp(text + i, pattern, m) == 0) {
+                (*match_count)++;
+                rk_stats.matches++;
+                record_match((int)i);
+            } else {
+                rk_stats.spurious_hits++;
+            }
+        }
+        if (i + m >= n)
+            break;
+        t = rk_roll(t, (uint8_t)text[i], (uint8_t)text[i + m], drop);
+    }
+}
+
+// Pattern hash set entry for the multi-pattern mode; pattern is the index + 1, 0 = empty
+typedef struct {
+    uint64_t hash;
+    int pattern;
+} RollingHashSlot;
+
+// Function to count, in one pass, the occurrences of many patterns that all have the same length:
+// the pattern hashes go into an open-addressing set and each window is looked up once. counts[p]
+// receives the occurrences of patterns[p]. Returns the total, or -1 if the lengths differ.
+long long rabin_karp_multi(const char *text, size_t n, const char *patterns[], int count, long long *counts) {
+    if (count <= 0)
+        return 0;
+    size_t m = strlen(patterns[0]);
+    for (int p = 0; p < count; p++) {
+        if (strlen(patterns[p]) != m)
+            return -1;
+        counts[p] = 0;
+    }
+    if (m == 0 || m > n)
+        return 0;
+
+    // Table at most 1/8 full, so most windows land on an empty slot and the probe branch is
+    // predictable. Slots are indexed by the top hash bits, the best mixed ones for this hash.
+    int bits = 4;
+    while ((1ull << bits) < 8 * (uint64_t)count)
+        bits++;
+    size_t slots = (size_t)1 << bits;
+    RollingHashSlot *table = calloc(slots, sizeof(RollingHashSlot));
+    for (int p = 0; p < count; p++) {
+        uint64_t h = rk_hash(patterns[p], m);
+        size_t k = h >> (64 - bits);
+        while (table[k].pattern)
+            k = (k + 1) & (slots - 1);
+        table[k].hash = h;
+        table[k].pattern = p + 1;
+    }
+
+    uint64_t drop[256];
+    rk_drop_table(m, drop);
+
+    long long total = 0;
+    uint64_t t = rk_hash(text, m);
+    rk_stats.windows += n - m + 1;
+    for (size_t i = 0;; i++) {
+        // Probe until an empty slot; duplicates of a pattern sit in the same cluster
+        for (size_t k = t >> (64 - bits); table[k].pattern; k = (k + 1) & (slots - 1)) {
+            if (table[k].hash != t)
+                continue;
+            rk_stats.hash_hits++;
+            int p = table[k].pattern - 1;
+            if (memcmp(text + i, patterns[p], m) == 0) {
+                counts[p]++;
+                total++;
+                rk_stats.matches++;
+            } else {
+                rk_stats.spurious_hits++;
+            }
+        }
+        if (i + m >= n)
+            break;
+        t = rk_roll(t, (uint8_t)text[i], (uint8_t)text[i + m], drop);
+    }
+    free(table);
+    return total;
+}
+
 // Knuth-Morris-Pratt Algorithm
 void KMPSearch(const char *text, const char *pattern, int *match_count) {
     int m = strlen(pattern);
@@ -93,6 +443,7 @@ void KMPSearch(const char *text, const char *pattern, int *match_count) {
         }
         if (j == m) {
             (*match_count)++;  // Increment match count if pattern is found
+            record_match(i - j);
             j = lps[j - 1];
         } else if (i < n && pattern[j] != text[i]) {
             if (j != 0) {
@@ -126,6 +477,805 @@ void computeLPSArray(const char *pattern, int m, int *lps) {
     }
 }
 
+// ==================== Skip-based searchers ====================
+// Boyer-Moore-Horspool: compare the window's last byte first and, on any outcome, shift by the
+// distance from that byte's last occurrence in pattern[0..m-2] to the end of the pattern
+void horspool_search(const char *text, const char *pattern, int *match_count) {
+    size_t n = strlen(text), m = strlen(pattern);
+    if (m == 0 || m > n) {
+        naive_string_match(text, pattern, match_count);
+        return;
+    }
+    size_t shift[256];
+    for (int c = 0; c < 256; c++)
+        shift[c] = m;
+    for (size_t i = 0; i + 1 < m; i++)
+        shift[(uint8_t)pattern[i]] = m - 1 - i;
+
+    uint8_t last = (uint8_t)pattern[m - 1];
+    for (size_t i = 0; i <= n - m;) {
+        uint8_t c = (uint8_t)text[i + m - 1];
+        if (c == last && memcmp(text + i, pattern, m - 1) == 0) {
+            (*match_count)++;
+            record_match((int)i);
+        }
+        i += shift[c];
+    }
+}
+
+// Function to compute the maximal suffix of x under the byte order (reversed when `reverse` is
+// set); returns its start - 1 and stores its period in *period
+static int maximal_suffix(const uint8_t *x, int m, int reverse, int *period) {
+    int ms = -1, j = 0, k = 1, p = 1;
+    while (j + k < m) {
+        uint8_t a = x[j + k], b = x[ms + k];
+        if (reverse ? a > b : a < b) {
+            j += k;
+            k = 1;
+            p = j - ms;
+        } else if (a == b) {
+            if (k != p) {
+                k++;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            ms = j;
+            j = ms + 1;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return ms;
+}
+
+// Crochemore-Perrin Two-Way: split the pattern at a critical factorization x = u v, match v left
+// to right, then u right to left. Linear time in the worst case with O(1) extra space. When the
+// pattern is periodic, `memory` remembers the prefix already known to match after a shift.
+void two_way_search(const char *text, const char *pattern, int *match_count) {
+    int n = strlen(text), m = strlen(pattern);
+    if (m == 0 || m > n) {
+        naive_string_match(text, pattern, match_count);
+        return;
+    }
+    const uint8_t *x = (const uint8_t *)pattern, *y = (const uint8_t *)text;
+    int p, q;
+    int i = maximal_suffix(x, m, 0, &p);
+    int j = maximal_suffix(x, m, 1, &q);
+    int ell = i > j ? i : j;
+    int period = i > j ? p : q;
+
+    if (memcmp(x, x + period, ell + 1) == 0) {
+        // u is a suffix of v's first period: the pattern has period `period`
+        int memory = -1;
+        for (j = 0; j <= n - m;) {
+            i = (ell > memory ? ell : memory) + 1;
+            while (i < m && x[i] == y[i + j])
+                i++;
+            if (i >= m) {
+                i = ell;
+                while (i > memory && x[i] == y[i + j])
+                    i--;
+                if (i <= memory) {
+                    (*match_count)++;
+                    record_match(j);
+                }
+                j += period;
+                memory = m - period - 1;
+            } else {
+                j += i - ell;
+                memory = -1;
+            }
+        }
+    } else {
+        // No small period: any shift up to max(|u|, |v|) + 1 is safe
+        period = (ell + 1 > m - ell - 1 ? ell + 1 : m - ell - 1) + 1;
+        for (j = 0; j <= n - m;) {
+            i = ell + 1;
+            while (i < m && x[i] == y[i + j])
+                i++;
+            if (i >= m) {
+                i = ell;
+                while (i >= 0 && x[i] == y[i + j])
+                    i--;
+                if (i < 0) {
+                    (*match_count)++;
+                    record_match(j);
+                }
+                j += period;
+            } else {
+                j += i - ell;
+            }
+        }
+    }
+}
+
+// ==================== Algorithm selection ====================
+// Queries are bucketed by alphabet size (distinct bytes in a sample of the text), pattern length
+// and text length; each bucket holds the matcher that calibrate_selector measured fastest. The
+// defaults below are only used until calibration runs.
+static const struct {
+    const char *name;
+    MatchFunc func;
+} matchers[] = {
+    {"naive", naive_string_match},
+    {"simd", simd_string_match},
+    {"rabin-karp", rabin_karp},
+    {"rabin-karp64", rabin_karp64},
+    {"kmp", KMPSearch},
+    {"horspool", horspool_search},
+    {"two-way", two_way_search},
+};
+
+#define SELECT_ALPHABETS 3      // <= 4 distinct bytes, <= 32, more
+#define SELECT_LENGTHS 4        // m < 4, < 16, < 64, longer
+#define SELECT_TEXTS 2          // n < 1024, longer
+#define SELECT_SAMPLE 4096      // Text bytes inspected to estimate the alphabet
+
+static const int alphabet_examples[SELECT_ALPHABETS] = {4, 26, 200};
+static const int length_examples[SELECT_LENGTHS] = {2, 8, 32, 128};
+static const int text_examples[SELECT_TEXTS] = {256, 1 << 18};
+
+static MatchFunc selector_table[SELECT_ALPHABETS][SELECT_LENGTHS][SELECT_TEXTS] = {
+    {{simd_string_match, simd_string_match}, {simd_string_match, simd_string_match},
+     {simd_string_match, simd_string_match}, {two_way_search, two_way_search}},
+    {{simd_string_match, simd_string_match}, {simd_string_match, simd_string_match},
+     {simd_string_match, horspool_search}, {horspool_search, horspool_search}},
+    {{simd_string_match, simd_string_match}, {simd_string_match, simd_string_match},
+     {horspool_search, horspool_search}, {horspool_search, horspool_search}},
+};
+
+static const char *matcher_name(MatchFunc func) {
+    for (size_t a = 0; a < sizeof(matchers) / sizeof(matchers[0]); a++)
+        if (matchers[a].func == func)
+            return matchers[a].name;
+    return "?";
+}
+
+// Function to pick the matcher for a query from the calibrated table
+MatchFunc select_search_algorithm(size_t n, size_t m, int alphabet_size) {
+    int a = alphabet_size <= 4 ? 0 : alphabet_size <= 32 ? 1 : 2;
+    int l = m < 4 ? 0 : m < 16 ? 1 : m < 64 ? 2 : 3;
+    return selector_table[a][l][n < 1024 ? 0 : 1];
+}
+
+// Function to count the distinct bytes among the first SELECT_SAMPLE bytes of the text
+static int sample_alphabet(const char *text, size_t n) {
+    uint8_t seen[256] = {0};
+    int distinct = 0;
+    size_t limit = n < SELECT_SAMPLE ? n : SELECT_SAMPLE;
+    for (size_t i = 0; i < limit; i++) {
+        distinct += !seen[(uint8_t)text[i]];
+        seen[(uint8_t)text[i]] = 1;
+    }
+    return distinct;
+}
+
+// Automatic selection: same interface as the other matchers, dispatches per query
+void auto_string_match(const char *text, const char *pattern, int *match_count) {
+    size_t n = strlen(text), m = strlen(pattern);
+    select_search_algorithm(n, m, sample_alphabet(text, n))(text, pattern, match_count);
+}
+
+// Function to fill the selector table: for one example query per bucket (a random text and a
+// pattern sampled from it), time every candidate with measure_time and keep the fastest
+void calibrate_selector(int verbose) {
+    const MatchFunc candidates[] = {simd_string_match, rabin_karp64, KMPSearch, horspool_search, two_way_search};
+    const int candidate_count = sizeof(candidates) / sizeof(candidates[0]);
+    const int work = 1 << 21;  // Bytes scanned per measurement, so short texts repeat more
+    char *text = malloc(text_examples[SELECT_TEXTS - 1] + 1);
+    char pattern[129];
+
+    if (verbose)
+        printf("Selector calibration (fastest matcher per bucket):\n%9s %6s %8s %14s\n", "alphabet", "m", "n", "choice");
+    srand(49);
+    for (int a = 0; a < SELECT_ALPHABETS; a++) {
+        for (int t = 0; t < SELECT_TEXTS; t++) {
+            int n = text_examples[t];
+            for (int i = 0; i < n; i++)
+                text[i] = (char)(a == 0 ? "ACGT"[rand() % 4] : 32 + rand() % alphabet_examples[a]);
+            text[n] = '\0';
+            for (int l = 0; l < SELECT_LENGTHS; l++) {
+                int m = length_examples[l];
+                memcpy(pattern, text + rand() % (n - m + 1), m);
+                pattern[m] = '\0';
+                double best = 0;
+                for (int c = 0; c < candidate_count; c++) {
+                    int match_count = 0;
+                    double time = measure_time(candidates[c], text, pattern, &match_count, work / n);
+                    if (c == 0 || time < best) {
+                        best = time;
+                        selector_table[a][l][t] = candidates[c];
+                    }
+                }
+                if (verbose)
+                    printf("%9d %6d %8d %14s\n", alphabet_examples[a], m, n, matcher_name(selector_table[a][l][t]));
+            }
+        }
+    }
+    if (verbose)
+        printf("\n");
+    free(text);
+}
+
+// ==================== Aho-Corasick ====================
+// Build-time trie node: children kept as a sibling list, which is compact and fast enough to build
+typedef struct {
+    int first_child, next_sibling;
+    int pattern;
+    uint8_t byte;
+} TrieNode;
+
+static int trie_child(const TrieNode *trie, int node, uint8_t c) {
+    for (int k = trie[node].first_child; k >= 0; k = trie[k].next_sibling)
+        if (trie[k].byte == c)
+            return k;
+    return -1;
+}
+
+// Function to follow one byte from a state. Every state stores complete transitions, so this is
+// one lookup: a dense row, or a bitmap test plus a popcount into the packed sparse targets (classes
+// without a bit go where the root row sends them).
+static inline int ac_step(const AhoCorasick *ac, int state, uint8_t c) {
+    int k = ac->byte_class[c];
+    if (state < ac->dense_count)
+        return ac->dense_rows[(size_t)state * ac->class_count + k];
+    const ACSparseRow *row = &ac->sparse_rows[state - ac->dense_count];
+    uint64_t word = row->bits[k >> 6], bit = 1ull << (k & 63);
+    if (!(word & bit))
+        return ac->dense_rows[k];
+    return ac->sparse_targets[row->start + row->before[k >> 6] + __builtin_popcountll(word & (bit - 1))];
+}
+
+// Function to write the complete transition row of an already built state into row[0..class_count)
+static void ac_expand_row(const AhoCorasick *ac, int state, int row[256]) {
+    int classes = ac->class_count;
+    if (state < ac->dense_count) {
+        memcpy(row, ac->dense_rows + (size_t)state * classes, classes * sizeof(int));
+        return;
+    }
+    memcpy(row, ac->dense_rows, classes * sizeof(int));
+    const ACSparseRow *sparse = &ac->sparse_rows[state - ac->dense_count];
+    int t = sparse->start;
+    for (int k = 0; k < classes; k++)
+        if (sparse->bits[k >> 6] >> (k & 63) & 1)
+            row[k] = ac->sparse_targets[t++];
+}
+
+// Function to build the automaton: insert the patterns into a trie, renumber the nodes in BFS order,
+// then resolve every state's transitions level by level: a state's row is its fail state's row
+// with its own trie edges written over it, and a child's fail link is the fail state's transition
+// on the child's byte. Rows are indexed by byte class (one per byte used in the patterns, plus
+// one for the rest), which keeps them short enough that most automata are dense throughout. The
+// first states in BFS order (up to AC_MAX_DENSE_CELLS entries) keep the full row; any deeper
+// states keep only the entries that differ from the root row, so the search never walks fail links.
+AhoCorasick *ac_build(const char *patterns[], int count) {
+    int capacity = 1024, size = 1;
+    TrieNode *trie = malloc(capacity * sizeof(TrieNode));
+    trie[0] = (TrieNode){-1, -1, -1, 0};
+    AhoCorasick *ac = calloc(1, sizeof(AhoCorasick));
+    ac->pattern_count = count;
+    ac->same_pattern = malloc((count > 0 ? count : 1) * sizeof(int));
+    ac->pattern_length = malloc((count > 0 ? count : 1) * sizeof(int));
+
+    for (int p = 0; p < count; p++) {
+        int node = 0;
+        ac->pattern_length[p] = (int)strlen(patterns[p]);
+        ac->same_pattern[p] = -1;
+        for (const uint8_t *c = (const uint8_t *)patterns[p]; *c; c++) {
+            int next = trie_child(trie, node, *c);
+            if (next < 0) {
+                if (size == capacity) {
+                    capacity *= 2;
+                    trie = realloc(trie, capacity * sizeof(TrieNode));
+                }
+                next = size++;
+                trie[next] = (TrieNode){-1, trie[node].first_child, -1, *c};
+                trie[node].first_child = next;
+            }
+            node = next;
+        }
+        if (node == 0)
+            continue;  // Empty patterns never match
+        if (trie[node].pattern >= 0)
+            ac->same_pattern[p] = trie[node].pattern;
+        trie[node].pattern = p;
+    }
+
+    // BFS order: order[new] = old, rank[old] = new
+    int *order = malloc(size * sizeof(int));
+    int *rank = malloc(size * sizeof(int));
+    int head = 0, tail = 0;
+    order[tail++] = 0;
+    while (head < tail) {
+        int u = order[head++];
+        for (int k = trie[u].first_child; k >= 0; k = trie[k].next_sibling)
+            order[tail++] = k;
+    }
+    for (int i = 0; i < size; i++)
+        rank[order[i]] = i;
+
+    char used[256] = {0};
+    for (int i = 1; i < size; i++)
+        used[trie[i].byte] = 1;
+    int classes = 0;
+    for (int c = 0; c < 256; c++)
+        if (used[c])
+            ac->byte_class[c] = (uint8_t)classes++;
+    for (int c = 0; c < 256; c++)
+        if (!used[c])
+            ac->byte_class[c] = (uint8_t)classes;
+    if (classes < 256)
+        classes++;
+    ac->class_count = classes;
+
+    ac->node_count = size;
+    ac->nodes = malloc(size * sizeof(ACNode));
+    ac->output = malloc(size * sizeof(int));
+    int dense_count = 0;
+    while (dense_count < size && (size_t)(dense_count + 1) * classes <= AC_MAX_DENSE_CELLS)
+        dense_count++;
+    if (dense_count == 0)
+        dense_count = 1;  // The root row is the fallback of every sparse state
+    ac->dense_count = dense_count;
+    ac->dense_rows = malloc((size_t)dense_count * classes * sizeof(int));
+    ac->sparse_rows = malloc((size - dense_count > 0 ? size - dense_count : 1) * sizeof(ACSparseRow));
+    int target_capacity = 1024, target_count = 0;
+    ac->sparse_targets = malloc(target_capacity * sizeof(int));
+    for (int i = 0; i < size; i++)
+        ac->nodes[i] = (ACNode){0, trie[order[i]].pattern};
+
+    // In BFS order every state this touches (the fail state and its row) has a smaller index, so it
+    // is already complete
+    int row[256];
+    for (int i = 0; i < size; i++) {
+        ACNode *node = &ac->nodes[i];
+        ac->output[i] = node->pattern >= 0 ? i : (i > 0 ? ac->output[node->fail] : -1);
+        if (i == 0)
+            memset(row, 0, sizeof(row));
+        else
+            ac_expand_row(ac, node->fail, row);
+        for (int k = trie[order[i]].first_child; k >= 0; k = trie[k].next_sibling) {
+            int byte_class = ac->byte_class[trie[k].byte];
+            ac->nodes[rank[k]].fail = row[byte_class];
+            row[byte_class] = rank[k];
+        }
+
+        if (i < dense_count) {
+            memcpy(ac->dense_rows + (size_t)i * classes, row, classes * sizeof(int));
+            continue;
+        }
+        ACSparseRow *sparse = &ac->sparse_rows[i - dense_count];
+        memset(sparse, 0, sizeof(*sparse));
+        sparse->start = target_count;
+        for (int k = 0; k < classes; k++) {
+            if (row[k] == ac->dense_rows[k])
+                continue;
+            if (target_count == target_capacity) {
+                target_capacity *= 2;
+                ac->sparse_targets = realloc(ac->sparse_targets, target_capacity * sizeof(int));
+            }
+            ac->sparse_targets[target_count++] = row[k];
+            sparse->bits[k >> 6] |= 1ull << (k & 63);
+        }
+        for (int w = 1; w < 4; w++)
+            sparse->before[w] = sparse->before[w - 1] + __builtin_popcountll(sparse->bits[w - 1]);
+    }
+    free(order);
+    free(rank);
+    free(trie);
+    return ac;
+}
+
+// Function to scan the text once, calling report(pattern, offset) for every occurrence of every
+// pattern (offset is where the match starts). Returns the total number of occurrences.
+long long ac_search(const AhoCorasick *ac, const char *text, size_t n,
+                    void (*report)(int pattern, size_t offset, void *context), void *context) {
+    long long matches = 0;
+    int state = 0;
+    for (size_t i = 0; i < n; i++) {
+        state = ac_step(ac, state, (uint8_t)text[i]);
+        for (int out = ac->output[state]; out >= 0; out = ac->output[ac->nodes[out].fail]) {
+            for (int p = ac->nodes[out].pattern; p >= 0; p = ac->same_pattern[p]) {
+                matches++;
+                if (report)
+                    report(p, i + 1 - ac->pattern_length[p], context);
+            }
+        }
+    }
+    return matches;
+}
+
+// Function to release the automaton
+void ac_free(AhoCorasick *ac) {
+    if (!ac)
+        return;
+    free(ac->nodes);
+    free(ac->dense_rows);
+    free(ac->sparse_rows);
+    free(ac->sparse_targets);
+    free(ac->output);
+    free(ac->same_pattern);
+    free(ac->pattern_length);
+    free(ac);
+}
+
+// ==================== Suffix array and FM-index ====================
+// For many queries against one fixed text: the suffix array (built with SA-IS in linear time)
+// answers count and locate by binary search in O(m log n), and the FM-index answers count by
+// backward search in O(m) steps, using about a quarter of the memory.
+#define FM_BLOCK 64             // BWT rows per block count (the last partial block is scanned)
+#define FM_SUPERBLOCK 65536     // Rows per 32-bit superblock count; block counts are 16-bit offsets
+#define FM_SAMPLE 32            // Every FM_SAMPLE-th text position keeps its suffix array entry
+
+// Suffix array with its LCP array (lcp[r] = longest common prefix of suffixes sa[r-1] and sa[r])
+typedef struct {
+    const uint8_t *text;
+    int n;
+    int *sa;
+    int *lcp;
+} SuffixIndex;
+
+// FM-index over the BWT of text + sentinel (n + 1 rows); symbols are remapped to codes 1..sigma
+// in byte order, code 0 being the sentinel
+typedef struct {
+    int rows;
+    int sigma;                  // Distinct bytes in the text, plus 1 for the sentinel
+    uint8_t code[256];          // Byte -> code, 0 if the byte never occurs
+    uint8_t *bwt;               // BWT as codes
+    int *first;                 // first[c] = rows whose first symbol is smaller than c (the C array)
+    uint32_t *super_counts;     // super_counts[s * sigma + c]: occurrences of c before superblock s
+    uint16_t *block_counts;     // block_counts[b * sigma + c]: occurrences since the superblock start
+    uint64_t *sampled;          // Bit r set when row r's suffix starts at a sampled text position
+    int *sampled_rank;          // Set bits before each 64-bit word
+    int *samples;               // Suffix start for each set bit, in row order
+    size_t bytes;
+} FMIndex;
+
+// Function to place LMS suffixes at the ends of their buckets, then induce the L-type suffixes
+// left to right and the S-type suffixes right to left
+static void induce_sort(const int *s, int n, int upper, const uint8_t *is_s, const int *sum_s, const int *sum_l,
+                        const int *lms, int lms_count, int *sa, int *bucket) {
+    for (int i = 0; i < n; i++)
+        sa[i] = -1;
+    memcpy(bucket, sum_s, (upper + 1) * sizeof(int));
+    for (int k = 0; k < lms_count; k++)
+        if (lms[k] != n)
+            sa[bucket[s[lms[k]]]++] = lms[k];
+    memcpy(bucket, sum_l, (upper + 1) * sizeof(int));
+    sa[bucket[s[n - 1]]++] = n - 1;
+    for (int i = 0; i < n; i++) {
+        int v = sa[i];
+        if (v >= 1 && !is_s[v - 1])
+            sa[bucket[s[v - 1]]++] = v - 1;
+    }
+    memcpy(bucket, sum_l, (upper + 1) * sizeof(int));
+    for (int i = n - 1; i >= 0; i--) {
+        int v = sa[i];
+        if (v >= 1 && is_s[v - 1])
+            sa[--bucket[s[v - 1] + 1]] = v - 1;
+    }
+}
+
+// Function to build the suffix array of s[0..n-1] (symbols in 0..upper) with SA-IS: sort the
+// LMS substrings by induced sorting, name them, recurse on the reduced string if names repeat,
+// then induce the full order from the sorted LMS suffixes
+static void sa_is(const int *s, int n, int upper, int *sa) {
+    if (n == 0)
+        return;
+    if (n == 1) {
+        sa[0] = 0;
+        return;
+    }
+    if (n == 2) {
+        sa[0] = s[0] < s[1] ? 0 : 1;
+        sa[1] = 1 - sa[0];
+        return;
+    }
+
+    // is_s[i]: suffix i is S-type (smaller than suffix i + 1)
+    uint8_t *is_s = calloc(n, 1);
+    for (int i = n - 2; i >= 0; i--)
+        is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+
+    // Bucket starts for the S-type and L-type parts of each symbol's bucket
+    int *sum_l = calloc(upper + 2, sizeof(int));
+    int *sum_s = calloc(upper + 2, sizeof(int));
+    int *bucket = malloc((upper + 2) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        if (!is_s[i])
+            sum_s[s[i]]++;
+        else
+            sum_l[s[i] + 1]++;
+    }
+    for (int c = 0; c <= upper; c++) {
+        sum_s[c] += sum_l[c];
+        if (c < upper)
+            sum_l[c + 1] += sum_s[c];
+    }
+
+    int *lms_map = malloc((n + 1) * sizeof(int));
+    int lms_count = 0;
+    for (int i = 0; i <= n; i++)
+        lms_map[i] = -1;
+    for (int i = 1; i < n; i++)
+        if (!is_s[i - 1] && is_s[i])
+            lms_map[i] = lms_count++;
+    int *lms = calloc(lms_count + 1, sizeof(int));
+    for (int i = 1, k = 0; i < n; i++)
+        if (!is_s[i - 1] && is_s[i])
+            lms[k++] = i;
+
+    induce_sort(s, n, upper, is_s, sum_s, sum_l, lms, lms_count, sa, bucket);
+
+    if (lms_count > 0) {
+        int *sorted_lms = malloc(lms_count * sizeof(int));
+        for (int i = 0, k = 0; i < n; i++)
+            if (lms_map[sa[i]] != -1)
+                sorted_lms[k++] = sa[i];
+
+        // Name the LMS substrings: equal substrings get equal names
+        int *reduced = malloc(lms_count * sizeof(int));
+        int names = 0;
+        reduced[lms_map[sorted_lms[0]]] = 0;
+        for (int i = 1; i < lms_count; i++) {
+            int l = sorted_lms[i - 1], r = sorted_lms[i];
+            int end_l = lms_map[l] + 1 < lms_count ? lms[lms_map[l] + 1] : n;
+            int end_r = lms_map[r] + 1 < lms_count ? lms[lms_map[r] + 1] : n;
+            int same = 1;
+            if (end_l - l != end_r - r) {
+                same = 0;
+            } else {
+                while (l < end_l && s[l] == s[r]) {
+                    l++;
+                    r++;
+                }
+                if (l == n || s[l] != s[r])
+                    same = 0;
+            }
+            if (!same)
+                names++;
+            reduced[lms_map[sorted_lms[i]]] = names;
+        }
+
+        int *reduced_sa = malloc(lms_count * sizeof(int));
+        sa_is(reduced, lms_count, names, reduced_sa);
+        for (int i = 0; i < lms_count; i++)
+            sorted_lms[i] = lms[reduced_sa[i]];
+        induce_sort(s, n, upper, is_s, sum_s, sum_l, sorted_lms, lms_count, sa, bucket);
+        free(reduced_sa);
+        free(reduced);
+        free(sorted_lms);
+    }
+    free(lms);
+    free(lms_map);
+    free(bucket);
+    free(sum_s);
+    free(sum_l);
+    free(is_s);
+}
+
+// Function to build the suffix array and, with Kasai's algorithm, the LCP array of text[0..n-1]
+SuffixIndex *suffix_index_build(const char *text, int n) {
+    SuffixIndex *idx = malloc(sizeof(SuffixIndex));
+    idx->text = (const uint8_t *)text;
+    idx->n = n;
+    idx->sa = malloc((n > 0 ? n : 1) * sizeof(int));
+    idx->lcp = malloc((n > 0 ? n : 1) * sizeof(int));
+
+    int *s = calloc(n > 0 ? n : 1, sizeof(int));
+    for (int i = 0; i < n; i++)
+        s[i] = idx->text[i];
+    sa_is(s, n, 255, idx->sa);
+
+    // Kasai: walk suffixes in text order, the LCP drops by at most one each step
+    int *rank = s;
+    for (int r = 0; r < n; r++)
+        rank[idx->sa[r]] = r;
+    for (int i = 0, h = 0; i < n; i++) {
+        if (rank[i] == 0) {
+            idx->lcp[0] = 0;
+            h = 0;
+            continue;
+        }
+        int j = idx->sa[rank[i] - 1];
+        while (i + h < n && j + h < n && idx->text[i + h] == idx->text[j + h])
+            h++;
+        idx->lcp[rank[i]] = h;
+        if (h > 0)
+            h--;
+    }
+    free(s);
+    return idx;
+}
+
+// Function to compare the first m bytes of suffix i with the pattern (a suffix shorter than the
+// pattern that agrees on all its bytes is smaller)
+static int compare_suffix(const SuffixIndex *idx, int i, const uint8_t *pattern, int m) {
+    int length = idx->n - i < m ? idx->n - i : m;
+    int c = memcmp(idx->text + i, pattern, length);
+    return c != 0 ? c : (length < m ? -1 : 0);
+}
+
+// Function to find the rows whose suffixes start with the pattern: returns the count and stores
+// the first row in *first
+int suffix_index_count(const SuffixIndex *idx, const char *pattern, int *first) {
+    const uint8_t *p = (const uint8_t *)pattern;
+    int m = strlen(pattern), lo = 0, hi = idx->n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compare_suffix(idx, idx->sa[mid], p, m) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    int start = lo;
+    hi = idx->n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compare_suffix(idx, idx->sa[mid], p, m) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (first)
+        *first = start;
+    return lo - start;
+}
+
+// Function to list up to max_positions match offsets (in suffix order). After the first row is
+// found by binary search, the run of matching rows is the run with lcp >= m, so no second search
+// is needed. Returns the number of occurrences listed.
+int suffix_index_locate(const SuffixIndex *idx, const char *pattern, int *positions, int max_positions) {
+    int first, m = strlen(pattern);
+    if (m == 0 || suffix_index_count(idx, pattern, &first) == 0)
+        return 0;
+    int found = 0;
+    for (int r = first; found < max_positions && (r == first || (r < idx->n && idx->lcp[r] >= m)); r++)
+        positions[found++] = idx->sa[r];
+    return found;
+}
+
+size_t suffix_index_bytes(const SuffixIndex *idx) {
+    return 2 * (size_t)idx->n * sizeof(int);
+}
+
+void suffix_index_free(SuffixIndex *idx) {
+    if (!idx)
+        return;
+    free(idx->sa);
+    free(idx->lcp);
+    free(idx);
+}
+
+// Function to count occurrences of code c in bwt[0..row)
+static inline int fm_occ(const FMIndex *fm, int c, int row) {
+    int block = row / FM_BLOCK;
+    int count = fm->super_counts[(size_t)(row / FM_SUPERBLOCK) * fm->sigma + c] +
+                fm->block_counts[(size_t)block * fm->sigma + c];
+    for (int r = block * FM_BLOCK; r < row; r++)
+        count += fm->bwt[r] == c;
+    return count;
+}
+
+// Function to build the FM-index from the text and its suffix array
+FMIndex *fm_index_build(const char *text, int n, const int *sa) {
+    FMIndex *fm = calloc(1, sizeof(FMIndex));
+    const uint8_t *t = (const uint8_t *)text;
+    int rows = n + 1;
+    fm->rows = rows;
+
+    int present[256] = {0};
+    for (int i = 0; i < n; i++)
+        present[t[i]] = 1;
+    fm->sigma = 1;
+    for (int c = 0; c < 256; c++)
+        if (present[c])
+            fm->code[c] = (uint8_t)fm->sigma++;
+
+    // Row 0 is the sentinel suffix; row r + 1 is suffix sa[r]
+    fm->bwt = malloc(rows);
+    fm->bwt[0] = n > 0 ? fm->code[t[n - 1]] : 0;
+    for (int r = 0; r < n; r++)
+        fm->bwt[r + 1] = sa[r] > 0 ? fm->code[t[sa[r] - 1]] : 0;
+
+    int sigma = fm->sigma;
+    int supers = rows / FM_SUPERBLOCK + 1, blocks = rows / FM_BLOCK + 1;
+    fm->first = calloc(sigma + 1, sizeof(int));
+    fm->super_counts = malloc((size_t)supers * sigma * sizeof(uint32_t));
+    fm->block_counts = malloc((size_t)blocks * sigma * sizeof(uint16_t));
+    uint32_t *running = calloc(sigma, sizeof(uint32_t));
+    uint32_t *super_base = calloc(sigma, sizeof(uint32_t));
+    for (int r = 0; r <= rows; r++) {
+        if (r % FM_SUPERBLOCK == 0 && r / FM_SUPERBLOCK < supers) {
+            memcpy(super_base, running, sigma * sizeof(uint32_t));
+            memcpy(fm->super_counts + (size_t)(r / FM_SUPERBLOCK) * sigma, running, sigma * sizeof(uint32_t));
+        }
+        if (r % FM_BLOCK == 0 && r / FM_BLOCK < blocks)
+            for (int c = 0; c < sigma; c++)
+                fm->block_counts[(size_t)(r / FM_BLOCK) * sigma + c] = (uint16_t)(running[c] - super_base[c]);
+        if (r < rows)
+            running[fm->bwt[r]]++;
+    }
+    for (int c = 0; c < sigma; c++)
+        fm->first[c + 1] = fm->first[c] + running[c];
+    free(running);
+    free(super_base);
+
+    // Sampled suffix array entries: rows whose suffix starts at a multiple of FM_SAMPLE
+    int words = rows / 64 + 1;
+    fm->sampled = calloc(words, sizeof(uint64_t));
+    fm->sampled_rank = malloc(words * sizeof(int));
+    fm->samples = malloc((n / FM_SAMPLE + 2) * sizeof(int));
+    for (int r = 0; r < n; r++)
+        if (sa[r] % FM_SAMPLE == 0)
+            fm->sampled[(r + 1) / 64] |= 1ull << ((r + 1) % 64);
+    for (int w = 0, total = 0; w < words; w++) {
+        fm->sampled_rank[w] = total;
+        total += __builtin_popcountll(fm->sampled[w]);
+    }
+    for (int r = 0, k = 0; r < n; r++)
+        if (sa[r] % FM_SAMPLE == 0)
+            fm->samples[k++] = sa[r];
+
+    fm->bytes = rows + (size_t)supers * sigma * sizeof(uint32_t) + (size_t)blocks * sigma * sizeof(uint16_t) +
+                (size_t)words * (sizeof(uint64_t) + sizeof(int)) + (size_t)(n / FM_SAMPLE + 1) * sizeof(int);
+    return fm;
+}
+
+// Function to find the BWT rows prefixed by the pattern with backward search: one pair of
+// occurrence lookups per pattern byte. Returns the count and stores the row range start in *first
+// (0 when nothing matches).
+int fm_index_count(const FMIndex *fm, const char *pattern, int *first) {
+    int sp = 0, ep = fm->rows;
+    for (int i = (int)strlen(pattern) - 1; i >= 0 && sp < ep; i--) {
+        int c = fm->code[(uint8_t)pattern[i]];
+        if (c == 0) {
+            if (first)
+                *first = 0;
+            return 0;
+        }
+        sp = fm->first[c] + fm_occ(fm, c, sp);
+        ep = fm->first[c] + fm_occ(fm, c, ep);
+    }
+    if (first)
+        *first = sp;
+    return ep - sp;
+}
+
+// Function to list up to max_positions match offsets: each row steps back through the text with
+// LF-mapping until it reaches a sampled position, at most FM_SAMPLE - 1 steps
+int fm_index_locate(const FMIndex *fm, const char *pattern, int *positions, int max_positions) {
+    int first;
+    int count = fm_index_count(fm, pattern, &first);
+    int found = 0;
+    for (int r = first; r < first + count && found < max_positions; r++) {
+        int row = r, steps = 0;
+        while (!(fm->sampled[row / 64] >> (row % 64) & 1)) {
+            int c = fm->bwt[row];
+            row = fm->first[c] + fm_occ(fm, c, row);
+            steps++;
+        }
+        int rank = fm->sampled_rank[row / 64] + __builtin_popcountll(fm->sampled[row / 64] & ((1ull << (row % 64)) - 1));
+        positions[found++] = fm->samples[rank] + steps;
+    }
+    return found;
+}
+
+void fm_index_free(FMIndex *fm) {
+    if (!fm)
+        return;
+    free(fm->bwt);
+    free(fm->first);
+    free(fm->super_counts);
+    free(fm->block_counts);
+    free(fm->sampled);
+    free(fm->sampled_rank);
+    free(fm->samples);
+    free(fm);
+}
+
 // Function to measure time taken by an algorithm
 double measure_time(void (*func)(const char*, const char*, int*), const char *text, const char *pattern, int *match_count, int repeats) {
     clock_t start, end;
@@ -137,8 +1287,717 @@ double measure_time(void (*func)(const char*, const char*, int*), const char *te
     return ((double)(end - start)) / CLOCKS_PER_SEC; // Return time in seconds
 }
 
-// Main function to test the algorithms
-int main() {
+// Function to read a monotonic clock in seconds
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Report callback that counts occurrences per pattern
+static void count_by_pattern(int pattern, size_t offset, void *context) {
+    (void)offset;
+    ((long long *)context)[pattern]++;
+}
+
+// Function to fill text[0..size-1] with words from a small vocabulary, the way log lines repeat
+// the same tokens, and NUL-terminate it
+static void make_log_text(char *text, size_t size) {
+    char vocabulary[200][12];
+    for (int w = 0; w < 200; w++) {
+        int len = 3 + rand() % 8;
+        for (int c = 0; c < len; c++)
+            vocabulary[w][c] = 'a' + rand() % 26;
+        vocabulary[w][len] = '\0';
+    }
+    size_t n = 0;
+    while (n < size) {
+        const char *word = vocabulary[rand() % 200];
+        for (const char *c = word; *c && n < size; c++)
+            text[n++] = *c;
+        if (n < size)
+            text[n++] = rand() % 16 == 0 ? '\n' : ' ';
+    }
+    text[n] = '\0';
+}
+
+// Function to fill text[0..size) with UTF-8 words of accented letters, so most bytes are >= 0x80
+static void make_utf8_text(char *text, size_t size) {
+    const char *letters[] = {"\xc3\xa9", "\xc3\xbc", "\xc3\x9f", "\xc3\xb8", "\xc3\xa5", "a", "n"};
+    size_t n = 0;
+    while (n < size) {
+        int len = 2 + rand() % 6;
+        for (int c = 0; c < len && n < size; c++)
+            for (const char *b = letters[rand() % 7]; *b && n < size; b++)
+                text[n++] = *b;
+        if (n < size)
+            text[n++] = ' ';
+    }
+    text[n] = '\0';
+}
+
+// Function to compare one Aho-Corasick pass over a log-like text against running KMPSearch
+// once per pattern. Patterns are substrings sampled from the text, so every one of them occurs.
+void benchmark_multi_pattern(void) {
+    const size_t text_size = 4u << 20;
+    const int pattern_sets[] = {10, 100, 1000};
+    const int max_patterns = 1000;
+
+    srand(10);
+    char *text = malloc(text_size + 1);
+    make_log_text(text, text_size);
+    size_t n = text_size;
+
+    char **storage = malloc(max_patterns * sizeof(char *));
+    for (int p = 0; p < max_patterns; p++) {
+        int len = 6 + rand() % 11;
+        size_t at = (size_t)rand() * 7919 % (n - len);
+        storage[p] = malloc(len + 1);
+        memcpy(storage[p], text + at, len);
+        storage[p][len] = '\0';
+    }
+    const char **patterns = (const char **)storage;
+
+    printf("Multi-pattern search over %.1f MB of log-like text:\n", n / 1e6);
+    printf("%8s %8s %8s %8s %12s %12s %12s %12s %9s\n", "patterns", "states", "classes", "dense", "matches", "AC GB/s",
+           "KMP GB/s", "KMP time", "speedup");
+    long long *counts = malloc(max_patterns * sizeof(long long));
+    for (size_t s = 0; s < sizeof(pattern_sets) / sizeof(pattern_sets[0]); s++) {
+        int count = pattern_sets[s];
+        AhoCorasick *ac = ac_build(patterns, count);
+
+        const int ac_repeats = 5;
+        memset(counts, 0, count * sizeof(long long));
+        double start = wall_seconds();
+        long long ac_matches = 0;
+        for (int r = 0; r < ac_repeats; r++)
+            ac_matches = ac_search(ac, text, n, r == 0 ? count_by_pattern : NULL, counts);
+        double ac_time = (wall_seconds() - start) / ac_repeats;
+
+        long long kmp_matches = 0;
+        int mismatches = 0;
+        start = wall_seconds();
+        for (int p = 0; p < count; p++) {
+            int match_count = 0;
+            KMPSearch(text, patterns[p], &match_count);
+            kmp_matches += match_count;
+            if (match_count != counts[p])
+                mismatches++;
+        }
+        double kmp_time = wall_seconds() - start;
+
+        printf("%8d %8d %8d %8d %12lld %12.3f %12.3f %11.3fs %8.1fx%s\n", count, ac->node_count, ac->class_count,
+               ac->dense_count, ac_matches,
+               n / ac_time / 1e9, n * (double)count / kmp_time / 1e9, kmp_time, kmp_time / ac_time,
+               mismatches || ac_matches != kmp_matches ? "  (count mismatch!)" : "");
+        ac_free(ac);
+    }
+    printf("(classes: distinct pattern bytes + 1; dense: states with a full row, the rest store differences "
+           "from the root row)\n");
+    printf("(KMP GB/s counts every pattern's pass over the text; speedup is time for all KMP passes over one AC pass)\n\n");
+
+    free(counts);
+    for (int p = 0; p < max_patterns; p++)
+        free(storage[p]);
+    free(storage);
+    free(text);
+}
+
+// Function to compare naive_string_match and simd_string_match through measure_time on
+// multi-MB texts: random bytes (candidates are rare) and DNA (4 letters, so first/last byte
+// filters pass far more often and verification dominates)
+void benchmark_simd_search(void) {
+    const int text_size = 8 << 20;
+    const int lengths[] = {4, 8, 16, 64};
+    const char *kinds[] = {"random", "DNA"};
+    char *text = malloc(text_size + 1);
+    char pattern[65];
+
+    printf("SIMD search (%s) on %d MB texts:\n", simd_search_name(), text_size >> 20);
+    printf("%8s %8s %10s %12s %12s %9s\n", "text", "m", "matches", "naive GB/s", "SIMD GB/s", "speedup");
+    srand(46);
+    for (int k = 0; k < 2; k++) {
+        for (int i = 0; i < text_size; i++)
+            text[i] = k == 0 ? (char)(1 + rand() % 255) : "ACGT"[rand() % 4];
+        text[text_size] = '\0';
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            int m = lengths[l];
+            memcpy(pattern, text + rand() % (text_size - m), m);
+            pattern[m] = '\0';
+
+            const int repeats = 3;
+            int match_count_naive = 0, match_count_simd = 0;
+            double time_naive = measure_time(naive_string_match, text, pattern, &match_count_naive, repeats);
+            double time_simd = measure_time(simd_string_match, text, pattern, &match_count_simd, repeats);
+            printf("%8s %8d %10d %12.3f %12.3f %8.1fx%s\n", kinds[k], m, match_count_simd / repeats,
+                   (double)text_size * repeats / time_naive / 1e9, (double)text_size * repeats / time_simd / 1e9,
+                   time_naive / time_simd, match_count_naive != match_count_simd ? "  (count mismatch!)" : "");
+        }
+    }
+    printf("\n");
+    free(text);
+}
+
+// ==================== Chunked search driver ====================
+// The file is cut into chunks of SEARCH_CHUNK_SIZE new bytes, each extended by m-1 bytes of the
+// next chunk. A match is found in the chunk where it starts, and only there: a chunk's search
+// window ends m-1 bytes past its last start position. Threads take chunks from a shared counter,
+// copy each into a NUL-terminated buffer and run an ordinary matcher on it; since a pattern never
+// contains a NUL byte, NUL bytes in the data just split the buffer into separate strings.
+typedef struct {
+    const char *data;      // Chunk bytes plus the overlap, not NUL-terminated
+    size_t length;
+    size_t base;           // File offset of data[0]
+    long long count;
+    MatchSink sink;
+} SearchChunk;
+
+typedef struct {
+    SearchChunk *chunks;
+    int chunk_count;
+    atomic_int next;
+    const char *pattern;
+    size_t m;
+    MatchFunc func;
+} ChunkBatch;
+
+// Function to search one chunk, string by string between NUL bytes
+static void search_chunk(SearchChunk *chunk, char *buffer, const char *pattern, size_t m, MatchFunc func) {
+    memcpy(buffer, chunk->data, chunk->length);
+    buffer[chunk->length] = '\0';
+    match_sink = &chunk->sink;
+    for (size_t start = 0; start < chunk->length;) {
+        size_t length = strlen(buffer + start);
+        if (length >= m) {
+            int match_count = 0;
+            chunk->sink.base = chunk->base + start;
+            func(buffer + start, pattern, &match_count);
+            chunk->count += match_count;
+        }
+        start += length + 1;
+    }
+    match_sink = NULL;
+}
+
+static void *chunk_worker(void *arg) {
+    ChunkBatch *batch = arg;
+    char *buffer = malloc(SEARCH_CHUNK_SIZE + batch->m);
+    for (int c; (c = atomic_fetch_add(&batch->next, 1)) < batch->chunk_count;)
+        search_chunk(&batch->chunks[c], buffer, batch->pattern, batch->m, batch->func);
+    free(buffer);
+    return NULL;
+}
+
+// Function to search a batch of chunks on up to `threads` threads, then fold the counts and
+// offsets into the result in chunk (file) order
+static void run_chunk_batch(SearchChunk *chunks, int chunk_count, const char *pattern, MatchFunc func,
+                            int threads, size_t max_offsets, SearchResult *result) {
+    ChunkBatch batch = {chunks, chunk_count, 0, pattern, strlen(pattern), func};
+    if (threads > chunk_count)
+        threads = chunk_count;
+    if (threads <= 1) {
+        chunk_worker(&batch);
+    } else {
+        pthread_t *ids = malloc(threads * sizeof(pthread_t));
+        for (int t = 0; t < threads; t++)
+            pthread_create(&ids[t], NULL, chunk_worker, &batch);
+        for (int t = 0; t < threads; t++)
+            pthread_join(ids[t], NULL);
+        free(ids);
+    }
+
+    for (int c = 0; c < chunk_count; c++) {
+        result->count += chunks[c].count;
+        size_t take = chunks[c].sink.count;
+        if (take > max_offsets - result->offset_count)
+            take = max_offsets - result->offset_count;
+        if (take > 0) {
+            result->offsets = realloc(result->offsets, (result->offset_count + take) * sizeof(size_t));
+            memcpy(result->offsets + result->offset_count, chunks[c].sink.offsets, take * sizeof(size_t));
+            result->offset_count += take;
+        }
+        free(chunks[c].sink.offsets);
+    }
+}
+
+static int check_search_args(const char *pattern, SearchResult *result) {
+    memset(result, 0, sizeof(*result));
+    if (pattern[0] == '\0') {
+        fprintf(stderr, "Pattern must not be empty\n");
+        return -1;
+    }
+    simd_search_name();  // Pick the SIMD implementation before any worker thread can race on it
+    return 0;
+}
+
+// Function to search a whole file through mmap; returns 0, or -1 if the file cannot be mapped
+int search_mapped_file(int fd, const char *pattern, MatchFunc func, int threads, size_t max_offsets, SearchResult *result) {
+    if (check_search_args(pattern, result) < 0)
+        return -1;
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror("fstat");
+        return -1;
+    }
+    double start = wall_seconds();
+    size_t size = st.st_size, m = strlen(pattern);
+    result->bytes = size;
+    if (size == 0)
+        return 0;
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    int chunk_count = (int)((size + SEARCH_CHUNK_SIZE - 1) / SEARCH_CHUNK_SIZE);
+    SearchChunk *chunks = calloc(chunk_count, sizeof(SearchChunk));
+    for (int c = 0; c < chunk_count; c++) {
+        size_t base = (size_t)c * SEARCH_CHUNK_SIZE;
+        size_t end = base + SEARCH_CHUNK_SIZE + m - 1;
+        chunks[c].data = data + base;
+        chunks[c].length = (end < size ? end : size) - base;
+        chunks[c].base = base;
+        chunks[c].sink.limit = max_offsets;
+    }
+    run_chunk_batch(chunks, chunk_count, pattern, func, threads, max_offsets, result);
+
+    free(chunks);
+    munmap((void *)data, size);
+    result->seconds = wall_seconds() - start;
+    return 0;
+}
+
+// Function to search a stream (a pipe or stdin) that cannot be mapped: read up to `threads`
+// chunks at a time, carrying the last m-1 bytes of each batch into the next one
+int search_stream(FILE *in, const char *pattern, MatchFunc func, int threads, size_t max_offsets, SearchResult *result) {
+    if (check_search_args(pattern, result) < 0)
+        return -1;
+    if (threads < 1)
+        threads = 1;
+    double start = wall_seconds();
+    size_t m = strlen(pattern), overlap = m - 1;
+    size_t region_size = (size_t)threads * SEARCH_CHUNK_SIZE + overlap;
+    char *region = malloc(region_size);
+    SearchChunk *chunks = malloc(threads * sizeof(SearchChunk));
+    size_t carried = 0, base = 0;
+
+    for (;;) {
+        // region = carried overlap + up to `threads` chunks of new bytes
+        size_t filled = carried;
+        size_t got;
+        while (filled < region_size && (got = fread(region + filled, 1, region_size - filled, in)) > 0)
+            filled += got;
+        size_t fresh = filled - carried;
+        if (fresh == 0)
+            break;
+        result->bytes += fresh;
+
+        // Chunk c owns start positions [c * CHUNK, (c + 1) * CHUNK) of the region
+        int chunk_count = 0;
+        for (size_t owned = 0; owned < filled && (owned == 0 || owned + overlap < filled); owned += SEARCH_CHUNK_SIZE) {
+            size_t end = owned + SEARCH_CHUNK_SIZE + overlap;
+            chunks[chunk_count] = (SearchChunk){region + owned, (end < filled ? end : filled) - owned, base + owned, 0,
+                                                {0, NULL, 0, 0, max_offsets}};
+            chunk_count++;
+        }
+        run_chunk_batch(chunks, chunk_count, pattern, func, threads, max_offsets, result);
+
+        // Start positions before filled - overlap are done; keep the rest for the next batch
+        size_t done = filled > overlap ? filled - overlap : 0;
+        if (done > (size_t)chunk_count * SEARCH_CHUNK_SIZE)
+            done = (size_t)chunk_count * SEARCH_CHUNK_SIZE;
+        memmove(region, region + done, filled - done);
+        carried = filled - done;
+        base += done;
+        if (feof(in) || ferror(in))
+            break;
+    }
+    free(chunks);
+    free(region);
+    result->seconds = wall_seconds() - start;
+    return ferror(in) ? -1 : 0;
+}
+
+// Function to check the chunked driver against one in-memory naive search and report its
+// throughput for each matcher, over a temporary 64 MB log-like file and a UTF-8 file whose bytes
+// are mostly non-ASCII
+void benchmark_chunked_search(void) {
+    const size_t size = 64u << 20;
+    const char *names[] = {"naive", "simd", "rabin-karp", "kmp"};
+    const MatchFunc funcs[] = {naive_string_match, simd_string_match, rabin_karp, KMPSearch};
+    const int thread_counts[] = {1, 2, 4};
+
+    srand(47);
+    char *text = malloc(size + 1);
+    for (int kind = 0; kind < 2; kind++) {
+        if (kind == 0)
+            make_log_text(text, size);
+        else
+            make_utf8_text(text, size);
+        char pattern[9];
+        memcpy(pattern, text + size / 2, 8);
+        pattern[8] = '\0';
+        FILE *file = tmpfile();
+        if (!file || fwrite(text, 1, size, file) != size || fflush(file) != 0) {
+            perror("tmpfile");
+            free(text);
+            return;
+        }
+        int expected = 0;
+        naive_string_match(text, pattern, &expected);
+
+        printf("Chunked search over a %zu MB %s file (%d matches, %u MB chunks, %ld CPUs online):\n",
+               size >> 20, kind == 0 ? "log" : "UTF-8", expected, SEARCH_CHUNK_SIZE >> 20,
+               sysconf(_SC_NPROCESSORS_ONLN));
+        printf("%12s %8s %8s %10s %10s\n", "algorithm", "mode", "threads", "matches", "GB/s");
+        for (int a = 0; a < 4; a++) {
+            for (int t = 0; t < 4; t++) {
+                SearchResult result;
+                const char *mode = t < 3 ? "mmap" : "stream";
+                int threads = t < 3 ? thread_counts[t] : 4;
+                if (t < 3) {
+                    search_mapped_file(fileno(file), pattern, funcs[a], threads, 16, &result);
+                } else {
+                    rewind(file);
+                    search_stream(file, pattern, funcs[a], threads, 16, &result);
+                }
+                int offsets_ok = 1;
+                for (size_t o = 0; o < result.offset_count; o++)
+                    if (memcmp(text + result.offsets[o], pattern, 8) != 0 || (o > 0 && result.offsets[o] <= result.offsets[o - 1]))
+                        offsets_ok = 0;
+                printf("%12s %8s %8d %10lld %10.3f%s\n", names[a], mode, threads, result.count,
+                       result.bytes / result.seconds / 1e9,
+                       result.count != expected || !offsets_ok ? "  (mismatch!)" : "");
+                free(result.offsets);
+            }
+        }
+        printf("\n");
+        fclose(file);
+    }
+    free(text);
+}
+
+// Function to compare rabin_karp (q = 101) with rabin_karp64 on single patterns, then the
+// multi-pattern mode with Aho-Corasick on 100 and 1000 same-length patterns, printing the
+// hit counters for each run
+void benchmark_rolling_hash(void) {
+    const size_t size = 8u << 20;
+    const int lengths[] = {8, 32};
+    char *text = malloc(size + 1);
+    char pattern[33];
+
+    printf("Rolling hash Rabin-Karp on %zu MB texts:\n", size >> 20);
+    printf("%6s %4s %12s %10s %10s %12s %12s %10s\n", "text", "m", "version", "time", "GB/s", "hash hits", "spurious", "matches");
+    srand(48);
+    for (int kind = 0; kind < 2; kind++) {
+        if (kind == 0) {
+            make_log_text(text, size);
+        } else {
+            for (size_t i = 0; i < size; i++)
+                text[i] = "ACGT"[rand() % 4];
+            text[size] = '\0';
+        }
+        for (int l = 0; l < 2; l++) {
+            int m = lengths[l];
+            memcpy(pattern, text + (size_t)rand() * 31 % (size - m), m);
+            pattern[m] = '\0';
+            for (int v = 0; v < 2; v++) {
+                int match_count = 0;
+                memset(&rk_stats, 0, sizeof(rk_stats));
+                double time = measure_time(v == 0 ? rabin_karp : rabin_karp64, text, pattern, &match_count, 1);
+                printf("%6s %4d %12s %9.3fs %10.3f %12lld %12lld %10d\n", kind == 0 ? "log" : "DNA", m,
+                       v == 0 ? "q = 101" : "64-bit", time, size / time / 1e9, rk_stats.hash_hits,
+                       rk_stats.spurious_hits, match_count);
+            }
+        }
+    }
+
+    // Multi-pattern: 12-byte patterns sampled from the log text
+    make_log_text(text, size);
+    const int max_patterns = 1000, m = 12;
+    char (*storage)[13] = malloc(max_patterns * sizeof(*storage));
+    const char **patterns = malloc(max_patterns * sizeof(char *));
+    for (int p = 0; p < max_patterns; p++) {
+        memcpy(storage[p], text + (size_t)rand() * 7919 % (size - m), m);
+        storage[p][m] = '\0';
+        patterns[p] = storage[p];
+    }
+    long long *counts = malloc(max_patterns * sizeof(long long));
+    long long *ac_counts = malloc(max_patterns * sizeof(long long));
+    printf("\n%8s %14s %10s %14s %10s %12s %10s\n", "patterns", "multi-RK time", "GB/s", "Aho-Corasick", "GB/s", "spurious", "matches");
+    for (int count = 100; count <= max_patterns; count *= 10) {
+        memset(&rk_stats, 0, sizeof(rk_stats));
+        double start = wall_seconds();
+        long long total = rabin_karp_multi(text, size, patterns, count, counts);
+        double rk_time = wall_seconds() - start;
+
+        AhoCorasick *ac = ac_build(patterns, count);
+        memset(ac_counts, 0, count * sizeof(long long));
+        start = wall_seconds();
+        long long ac_total = ac_search(ac, text, size, count_by_pattern, ac_counts);
+        double ac_time = wall_seconds() - start;
+        ac_free(ac);
+
+        int mismatch = total != ac_total;
+        for (int p = 0; p < count; p++)
+            mismatch |= counts[p] != ac_counts[p];
+        printf("%8d %13.3fs %10.3f %13.3fs %10.3f %12lld %10lld%s\n", count, rk_time, size / rk_time / 1e9,
+               ac_time, size / ac_time / 1e9, rk_stats.spurious_hits, total, mismatch ? "  (count mismatch!)" : "");
+    }
+    printf("\n");
+    free(counts);
+    free(ac_counts);
+    free(patterns);
+    free(storage);
+    free(text);
+}
+
+// Function to compare the suffix array and FM-index with rescanning the text for every query:
+// build time, memory per text byte and queries per second on a 16 MB log-like text
+void benchmark_text_index(void) {
+    const int n = 16 << 20, query_count = 100000, scan_queries = 20, locate_limit = 100;
+    const int fm_locate_queries = query_count / 10;  // Each FM locate walks up to FM_SAMPLE - 1 LF steps per offset
+    srand(50);
+    char *text = malloc(n + 1);
+    make_log_text(text, n);
+
+    double start = wall_seconds();
+    SuffixIndex *idx = suffix_index_build(text, n);
+    double sa_time = wall_seconds() - start;
+    start = wall_seconds();
+    FMIndex *fm = fm_index_build(text, n, idx->sa);
+    double fm_time = wall_seconds() - start;
+
+    // Queries: substrings of the text (4..20 bytes), every tenth one altered so it may not occur
+    char (*queries)[21] = malloc(query_count * sizeof(*queries));
+    for (int q = 0; q < query_count; q++) {
+        int m = 4 + rand() % 17;
+        memcpy(queries[q], text + (size_t)rand() * 7919 % (n - m), m);
+        queries[q][m] = '\0';
+        if (q % 10 == 0)
+            queries[q][m / 2] = 'A' + rand() % 26;
+    }
+    int *sa_counts = malloc(query_count * sizeof(int));
+    int *positions = malloc(locate_limit * sizeof(int));
+
+    printf("Text index over %d MB of log-like text:\n", n >> 20);
+    printf("%-28s %10.3f s %8.2f bytes per text byte\n", "suffix array + LCP (SA-IS)", sa_time,
+           (double)suffix_index_bytes(idx) / n);
+    printf("%-28s %10.3f s %8.2f bytes per text byte\n", "FM-index (from the SA)", fm_time, (double)fm->bytes / n);
+
+    long long total = 0, located = 0;
+    int mismatches = 0;
+    start = wall_seconds();
+    for (int q = 0; q < query_count; q++)
+        total += sa_counts[q] = suffix_index_count(idx, queries[q], NULL);
+    double sa_count_time = wall_seconds() - start;
+    start = wall_seconds();
+    for (int q = 0; q < query_count; q++)
+        mismatches += fm_index_count(fm, queries[q], NULL) != sa_counts[q];
+    double fm_count_time = wall_seconds() - start;
+    start = wall_seconds();
+    for (int q = 0; q < query_count; q++)
+        located += suffix_index_locate(idx, queries[q], positions, locate_limit);
+    double sa_locate_time = wall_seconds() - start;
+    start = wall_seconds();
+    for (int q = 0; q < fm_locate_queries; q++)
+        fm_index_locate(fm, queries[q], positions, locate_limit);
+    double fm_locate_time = wall_seconds() - start;
+    start = wall_seconds();
+    for (int q = 0; q < scan_queries; q++) {
+        int match_count = 0;
+        simd_string_match(text, queries[q], &match_count);
+        mismatches += match_count != sa_counts[q];
+    }
+    double scan_time = wall_seconds() - start;
+
+    printf("%-28s %12.0f queries/s\n", "suffix array count", query_count / sa_count_time);
+    printf("%-28s %12.0f queries/s\n", "FM-index count", query_count / fm_count_time);
+    printf("%-28s %12.0f queries/s\n", "suffix array locate", query_count / sa_locate_time);
+    printf("%-28s %12.0f queries/s\n", "FM-index locate", fm_locate_queries / fm_locate_time);
+    printf("%-28s %12.1f queries/s\n", "SIMD rescan per query", scan_queries / scan_time);
+    printf("(%lld occurrences in %d queries, %lld listed with at most %d per query%s)\n\n", total, query_count,
+           located, locate_limit, mismatches ? ", count mismatch!" : "");
+
+    free(positions);
+    free(sa_counts);
+    free(queries);
+    fm_index_free(fm);
+    suffix_index_free(idx);
+    free(text);
+}
+
+// Function to answer every line of QUERYFILE as a pattern against the text in TEXTFILE from a
+// suffix array (or an FM-index), printing each count and the first `locate` offsets. Build and
+// query statistics go to stderr.
+static int run_index_batch(const char *text_file, const char *query_file, int use_fm, int locate) {
+    FILE *in = fopen(text_file, "rb");
+    FILE *query_in = fopen(query_file, "r");
+    if (!in || !query_in) {
+        fprintf(stderr, "Could not open %s or %s\n", text_file, query_file);
+        if (in)
+            fclose(in);
+        if (query_in)
+            fclose(query_in);
+        return 1;
+    }
+    size_t capacity = 1 << 20, n = 0, got;
+    char *text = malloc(capacity + 1);
+    while ((got = fread(text + n, 1, capacity - n, in)) > 0) {
+        n += got;
+        if (n == capacity)
+            text = realloc(text, (capacity *= 2) + 1);
+    }
+    fclose(in);
+    text[n] = '\0';
+    if (memchr(text, '\0', n) || n > INT32_MAX - 1) {
+        fprintf(stderr, "%s must be under 2 GB and contain no NUL bytes\n", text_file);
+        free(text);
+        fclose(query_in);
+        return 1;
+    }
+
+    int query_count = 0, query_capacity = 1024;
+    char **queries = malloc(query_capacity * sizeof(char *));
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &line_capacity, query_in)) >= 0) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+            line[--length] = '\0';
+        if (length == 0)
+            continue;
+        if (query_count == query_capacity)
+            queries = realloc(queries, (query_capacity *= 2) * sizeof(char *));
+        queries[query_count++] = strdup(line);
+    }
+    free(line);
+    fclose(query_in);
+
+    double start = wall_seconds();
+    SuffixIndex *idx = suffix_index_build(text, (int)n);
+    FMIndex *fm = NULL;
+    if (use_fm) {
+        fm = fm_index_build(text, (int)n, idx->sa);
+        suffix_index_free(idx);  // The FM-index keeps only its own samples
+        idx = NULL;
+    }
+    double build_time = wall_seconds() - start;
+    size_t index_bytes = fm ? fm->bytes : suffix_index_bytes(idx);
+
+    // Answer first (timed), then print
+    int *counts = malloc((query_count > 0 ? query_count : 1) * sizeof(int));
+    int *positions = malloc((locate > 0 ? locate : 1) * sizeof(int));
+    start = wall_seconds();
+    for (int q = 0; q < query_count; q++)
+        counts[q] = fm ? fm_index_count(fm, queries[q], NULL) : suffix_index_count(idx, queries[q], NULL);
+    double query_time = wall_seconds() - start;
+
+    for (int q = 0; q < query_count; q++) {
+        printf("%d %s\n", counts[q], queries[q]);
+        int listed = locate <= 0 ? 0 : fm ? fm_index_locate(fm, queries[q], positions, locate)
+                                         : suffix_index_locate(idx, queries[q], positions, locate);
+        for (int k = 0; k < listed; k++)
+            printf("Offset: %d\n", positions[k]);
+        free(queries[q]);
+    }
+    fflush(stdout);
+
+    fprintf(stderr, "Index: %s over %zu bytes, built in %.4f s, %.2f bytes per text byte\n",
+            fm ? "FM-index" : "suffix array + LCP", n, build_time, n ? (double)index_bytes / n : 0.0);
+    fprintf(stderr, "Queries: %d, %.3g queries/s (count only)\n", query_count,
+            query_time > 0 ? query_count / query_time : 0.0);
+
+    free(positions);
+    free(counts);
+    free(queries);
+    fm_index_free(fm);
+    suffix_index_free(idx);
+    free(text);
+    return 0;
+}
+
+// Function to parse a matcher name for the search command
+static MatchFunc match_func_by_name(const char *name) {
+    if (strcmp(name, "auto") == 0)
+        return auto_string_match;
+    for (size_t a = 0; a < sizeof(matchers) / sizeof(matchers[0]); a++)
+        if (strcmp(name, matchers[a].name) == 0)
+            return matchers[a].func;
+    return NULL;
+}
+
+// Function to run the search command: print the count, the first offsets and the throughput
+static int run_search(const char *algorithm, const char *pattern, const char *path, int threads, size_t max_offsets) {
+    MatchFunc func = match_func_by_name(algorithm);
+    if (!func) {
+        fprintf(stderr, "Unknown algorithm %s (naive, simd, rabin-karp, rabin-karp64, kmp, horspool, two-way, auto)\n", algorithm);
+        return 1;
+    }
+    SearchResult result;
+    int status;
+    if (strcmp(path, "-") == 0) {
+        status = search_stream(stdin, pattern, func, threads, max_offsets, &result);
+    } else {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            perror(path);
+            return 1;
+        }
+        status = search_mapped_file(fd, pattern, func, threads, max_offsets, &result);
+        close(fd);
+    }
+    if (status < 0)
+        return 1;
+
+    printf("Matches found: %lld\n", result.count);
+    for (size_t o = 0; o < result.offset_count; o++)
+        printf("Offset: %zu\n", result.offsets[o]);
+    printf("Searched %zu bytes in %f seconds (%.3f GB/s)\n", result.bytes, result.seconds,
+           result.seconds > 0 ? result.bytes / result.seconds / 1e9 : 0.0);
+    free(result.offsets);
+    return 0;
+}
+
+// Usage: lab10 [bench]
+//        lab10 search ALGORITHM PATTERN FILE [threads T] [offsets K]
+//        lab10 index TEXTFILE QUERYFILE [fm] [locate K]
+// Without arguments the five sample inputs are compared; bench adds the large-text benchmarks.
+// search looks for PATTERN in FILE (- reads stdin) with naive, simd, rabin-karp, rabin-karp64, kmp,
+// horspool, two-way or auto on T threads and prints the match count, the first K offsets
+// (10 by default) and GB/s. bench and search auto calibrate the automatic selection first; otherwise
+// it uses the compiled-in table. index builds a suffix array (or, with fm, an FM-index) over
+// TEXTFILE and prints the count and first K offsets of each line of QUERYFILE.
+int main(int argc, char *argv[]) {
+    if (argc > 4 && strcmp(argv[1], "search") == 0) {
+        int threads = 1;
+        size_t max_offsets = 10;
+        for (int a = 5; a + 1 < argc; a += 2) {
+            if (strcmp(argv[a], "threads") == 0)
+                threads = atoi(argv[a + 1]);
+            else if (strcmp(argv[a], "offsets") == 0)
+                max_offsets = strtoull(argv[a + 1], NULL, 10);
+        }
+        if (strcmp(argv[2], "auto") == 0)
+            calibrate_selector(0);
+        return run_search(argv[2], argv[3], argv[4], threads > 0 ? threads : 1, max_offsets);
+    }
+    if (argc > 3 && strcmp(argv[1], "index") == 0) {
+        int use_fm = 0, locate = 0;
+        for (int a = 4; a < argc; a++) {
+            if (strcmp(argv[a], "fm") == 0)
+                use_fm = 1;
+            else if (strcmp(argv[a], "locate") == 0 && a + 1 < argc)
+                locate = atoi(argv[++a]);
+        }
+        return run_index_batch(argv[2], argv[3], use_fm, locate);
+    }
+    // Calibration takes a while; only bench pays for it, the sample comparison uses the defaults
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+        calibrate_selector(1);
+
     const char *patterns[5] = {
         "ABAB",
         "ABCABCDABAB",
@@ -160,25 +2019,78 @@ int main() {
     // Loop through each input size
     for (int i = 0; i < 5; i++) {
         printf("Input %d:\n", i + 1);
-        int match_count_naive = 0, match_count_rabin = 0, match_count_kmp = 0;
+        int match_count_naive = 0, match_count_simd = 0, match_count_rabin = 0, match_count_rabin64 = 0, match_count_kmp = 0;
+        int match_count_horspool = 0, match_count_two_way = 0, match_count_auto = 0;
 
         // Measure and print time for Naive String Matching
         double time_naive = measure_time(naive_string_match, texts[i], patterns[i], &match_count_naive, repeats);
         printf("Naive String Matching:\nTime taken: %f seconds\nMatches found: %d\n\n", time_naive, match_count_naive);
 
+        // Measure and print time for the SIMD version of Naive String Matching
+        double time_simd = measure_time(simd_string_match, texts[i], patterns[i], &match_count_simd, repeats);
+        printf("SIMD Naive String Matching (%s):\nTime taken: %f seconds\nMatches found: %d\n\n", simd_search_name(), time_simd, match_count_simd);
+
         // Measure and print time for Rabin-Karp Algorithm
         double time_rabin = measure_time(rabin_karp, texts[i], patterns[i], &match_count_rabin, repeats);
         printf("Rabin-Karp Algorithm:\nTime taken: %f seconds\nMatches found: %d\n\n", time_rabin, match_count_rabin);
 
+        // Measure and print time for Rabin-Karp with the 64-bit rolling hash
+        double time_rabin64 = measure_time(rabin_karp64, texts[i], patterns[i], &match_count_rabin64, repeats);
+        printf("Rabin-Karp Algorithm (64-bit hash):\nTime taken: %f seconds\nMatches found: %d\n\n", time_rabin64, match_count_rabin64);
+
         // Measure and print time for Knuth-Morris-Pratt Algorithm
         double time_kmp = measure_time(KMPSearch, texts[i], patterns[i], &match_count_kmp, repeats);
         printf("Knuth-Morris-Pratt Algorithm:\nTime taken: %f seconds\nMatches found: %d\n\n", time_kmp, match_count_kmp);
 
+        // Measure and print time for Boyer-Moore-Horspool
+        double time_horspool = measure_time(horspool_search, texts[i], patterns[i], &match_count_horspool, repeats);
+        printf("Boyer-Moore-Horspool Algorithm:\nTime taken: %f seconds\nMatches found: %d\n\n", time_horspool, match_count_horspool);
+
+        // Measure and print time for Two-Way
+        double time_two_way = measure_time(two_way_search, texts[i], patterns[i], &match_count_two_way, repeats);
+        printf("Two-Way Algorithm:\nTime taken: %f seconds\nMatches found: %d\n\n", time_two_way, match_count_two_way);
+
+        // Measure and print time for the automatically selected algorithm
+        size_t text_length = strlen(texts[i]);
+        MatchFunc chosen = select_search_algorithm(text_length, strlen(patterns[i]), sample_alphabet(texts[i], text_length));
+        double time_auto = measure_time(auto_string_match, texts[i], patterns[i], &match_count_auto, repeats);
+        printf("Automatic selection (%s):\nTime taken: %f seconds\nMatches found: %d\n\n", matcher_name(chosen), time_auto, match_count_auto);
+
         // Final Comparison for the input
         printf("Performance Comparison for Input %d:\n", i + 1);
         printf("Naive: %f seconds, Matches: %d\n", time_naive, match_count_naive);
+        printf("SIMD Naive: %f seconds, Matches: %d\n", time_simd, match_count_simd);
         printf("Rabin-Karp: %f seconds, Matches: %d\n", time_rabin, match_count_rabin);
-        printf("KMP: %f seconds, Matches: %d\n\n", time_kmp, match_count_kmp);
+        printf("Rabin-Karp (64-bit): %f seconds, Matches: %d\n", time_rabin64, match_count_rabin64);
+        printf("KMP: %f seconds, Matches: %d\n", time_kmp, match_count_kmp);
+        printf("Horspool: %f seconds, Matches: %d\n", time_horspool, match_count_horspool);
+        printf("Two-Way: %f seconds, Matches: %d\n", time_two_way, match_count_two_way);
+        printf("Auto (%s): %f seconds, Matches: %d\n\n", matcher_name(chosen), time_auto, match_count_auto);
+    }
+
+    // Aho-Corasick: one automaton for all five patterns, one pass per text
+    AhoCorasick *ac = ac_build(patterns, 5);
+    printf("Aho-Corasick (all %d patterns in one pass, %d states):\n", 5, ac->node_count);
+    for (int i = 0; i < 5; i++) {
+        long long counts[5] = {0};
+        clock_t start = clock();
+        for (int r = 0; r < repeats; r++) {
+            memset(counts, 0, sizeof(counts));
+            ac_search(ac, texts[i], strlen(texts[i]), count_by_pattern, counts);
+        }
+        double time_ac = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+        printf("Input %d: %f seconds, Matches for pattern %d: %lld, Matches for all patterns: %lld\n",
+               i + 1, time_ac, i + 1, counts[i], counts[0] + counts[1] + counts[2] + counts[3] + counts[4]);
+    }
+    printf("\n");
+    ac_free(ac);
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        benchmark_multi_pattern();
+        benchmark_simd_search();
+        benchmark_chunked_search();
+        benchmark_rolling_hash();
+        benchmark_text_index();
     }
 
     return 0;
@@ -1,8 +1,48 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+
+#define PARALLEL_DEPTH 2   // Plan-tree depth down to which independent subtrees get their own thread
+#define BENCH_REPEAT 5     // Repetitions per timing
+
+// Structure to represent a dense row-major matrix
+typedef struct {
+    int rows;
+    int cols;
+    double *data;
+} Matrix;
+
+// Structure to represent an execution plan built from the split table s
+typedef struct {
+    int n;              // Number of entries in p (matrices are A1..A(n-1))
+    const int *p;       // Matrix dimensions
+    int *split;         // split[i * n + j] = s[i][j]
+    int *slot;          // slot[i * n + j] = pool buffer holding A_i..A_j (-1 for leaves and the root)
+    int slotCount;      // Number of pool buffers the plan needs
+    size_t *slotSize;   // Elements required by each pool buffer
+} ChainPlan;
+
+// Structure to hand one subtree to a worker thread
+typedef struct {
+    const ChainPlan *plan;
+    const Matrix *inputs;
+    double **pool;
+    int i, j;
+    Matrix *out;
+    int depth;
+} ChainTask;
 
 void print_optimal_parens(int , int , int n, int s[n][n], char *);
-void matrix_chain_order(int p[], int );
+long long matrix_chain_order(int p[], int n, int s[n][n]);
+void multiply_rect(const Matrix *A, const Matrix *B, Matrix *C);
+void build_chain_plan(ChainPlan *plan, int p[], int n, int s[n][n]);
+void free_chain_plan(ChainPlan *plan);
+void execute_chain_plan(const ChainPlan *plan, const Matrix inputs[], Matrix *result);
+void multiply_chain_naive(int p[], int n, const Matrix inputs[], Matrix *result);
 
 
 // Function to print the optimal parenthesization
@@ -19,9 +59,9 @@ void print_optimal_parens(int i, int j, int n, int s[n][n], char *name) {
 }
 
 // Function to find the minimum cost of matrix chain multiplication
-void matrix_chain_order(int p[], int n) {
-    int m[n][n];  // Table to store minimum multiplications
-    int s[n][n];  // Table to store split points
+// Fills the split table s and returns the minimum number of scalar multiplications
+long long matrix_chain_order(int p[], int n, int s[n][n]) {
+    long long m[n][n];  // Table to store minimum multiplications
 
     // Initialize number of multiplications for a single matrix as 0
     for (int i = 1; i < n; i++)
@@ -31,12 +71,12 @@ void matrix_chain_order(int p[], int n) {
     for (int L = 2; L < n; L++) {
         for (int i = 1; i < n - L + 1; i++) {
             int j = i + L - 1;
-            m[i][j] = INT_MAX;  // Initialize with a large value
+            m[i][j] = LLONG_MAX;  // Initialize with a large value
 
             // Test all positions to split the product
             for (int k = i; k <= j - 1; k++) {
                 // Calculate cost of scalar multiplications
-                int q = m[i][k] + m[k + 1][j] + p[i - 1] * p[k] * p[j];
+                long long q = m[i][k] + m[k + 1][j] + (long long)p[i - 1] * p[k] * p[j];
 
                 // Update minimum cost and store split point
                 if (q < m[i][j]) {
@@ -47,14 +87,226 @@ void matrix_chain_order(int p[], int n) {
         }
     }
 
-    // Output the minimum number of scalar multiplications
-    printf("Minimum number of multiplications is: %d\n", m[1][n - 1]);
+    return m[1][n - 1];
+}
 
-    // Output the optimal parenthesization
-    printf("Optimal parenthesization: ");
-    char name = '1';  // Start naming matrices as A1, A2, ...
-    print_optimal_parens(1, n - 1, n, s, &name);
-    printf("\n");
+// ==================== Plan Execution ====================
+// Function to multiply rectangular matrices: C = A * B (i-k-j order for unit-stride inner loop)
+void multiply_rect(const Matrix *A, const Matrix *B, Matrix *C) {
+    int n = A->rows, m = A->cols, p = B->cols;
+    memset(C->data, 0, (size_t)n * p * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        double *c = C->data + (size_t)i * p;
+        for (int k = 0; k < m; k++) {
+            double a = A->data[(size_t)i * m + k];
+            const double *b = B->data + (size_t)k * p;
+            for (int j = 0; j < p; j++)
+                c[j] += a * b[j];
+        }
+    }
+}
+
+// Liveness-based buffer assignment for the subtree A_i..A_j, using pool slots from base upwards.
+// The two child subtrees get disjoint slot ranges so they can run concurrently; once both are
+// done every slot in those ranges is dead except the two operands, so the product reuses one of them.
+// Returns the number of slots the subtree needs.
+static int assign_slots(ChainPlan *plan, int i, int j, int base, int isRoot) {
+    int n = plan->n;
+    if (i == j)
+        return 0;
+
+    int k = plan->split[i * n + j];
+    int needL = assign_slots(plan, i, k, base, 0);
+    int needR = assign_slots(plan, k + 1, j, base + needL, 0);
+    int need = needL + needR;
+
+    if (isRoot) {
+        plan->slot[i * n + j] = -1;  // The root writes straight into the caller's result
+        return need;
+    }
+
+    int resL = plan->slot[i * n + k];
+    int resR = plan->slot[(k + 1) * n + j];
+    int out = base;
+    while (out == resL || out == resR)
+        out++;
+    plan->slot[i * n + j] = out;
+
+    size_t size = (size_t)plan->p[i - 1] * plan->p[j];
+    if (size > plan->slotSize[out])
+        plan->slotSize[out] = size;
+    if (out - base + 1 > need)
+        need = out - base + 1;
+    if (out + 1 > plan->slotCount)
+        plan->slotCount = out + 1;
+    return need;
+}
+
+// Function to build an execution plan from the split table
+void build_chain_plan(ChainPlan *plan, int p[], int n, int s[n][n]) {
+    plan->n = n;
+    plan->p = p;
+    plan->split = malloc((size_t)n * n * sizeof(int));
+    plan->slot = malloc((size_t)n * n * sizeof(int));
+    plan->slotSize = calloc(n + 1, sizeof(size_t));
+    plan->slotCount = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            plan->split[i * n + j] = (i < j) ? s[i][j] : 0;
+            plan->slot[i * n + j] = -1;
+        }
+    }
+    assign_slots(plan, 1, n - 1, 0, 1);
+}
+
+void free_chain_plan(ChainPlan *plan) {
+    free(plan->split);
+    free(plan->slot);
+    free(plan->slotSize);
+}
+
+static void evaluate_subtree(const ChainPlan *plan, const Matrix inputs[], double **pool, int i, int j, Matrix *out, int depth);
+
+static void *evaluate_task(void *arg) {
+    ChainTask *t = (ChainTask *)arg;
+    evaluate_subtree(t->plan, t->inputs, t->pool, t->i, t->j, t->out, t->depth);
+    return NULL;
+}
+
+// Recursive function to evaluate the product A_i..A_j into out following the plan
+static void evaluate_subtree(const ChainPlan *plan, const Matrix inputs[], double **pool, int i, int j, Matrix *out, int depth) {
+    int n = plan->n;
+    int k = plan->split[i * n + j];
+    Matrix left = inputs[i - 1], right = inputs[k];
+
+    if (i != k)
+        left = (Matrix){plan->p[i - 1], plan->p[k], pool[plan->slot[i * n + k]]};
+    if (k + 1 != j)
+        right = (Matrix){plan->p[k], plan->p[j], pool[plan->slot[(k + 1) * n + j]]};
+
+    if (i != k && k + 1 != j && depth < PARALLEL_DEPTH) {
+        // Both operands are products: evaluate the left subtree on its own thread
+        pthread_t tid;
+        ChainTask task = {plan, inputs, pool, i, k, &left, depth + 1};
+        int spawned = pthread_create(&tid, NULL, evaluate_task, &task) == 0;
+        if (!spawned)
+            evaluate_subtree(plan, inputs, pool, i, k, &left, depth + 1);
+        evaluate_subtree(plan, inputs, pool, k + 1, j, &right, depth + 1);
+        if (spawned)
+            pthread_join(tid, NULL);
+    } else {
+        if (i != k)
+            evaluate_subtree(plan, inputs, pool, i, k, &left, depth + 1);
+        if (k + 1 != j)
+            evaluate_subtree(plan, inputs, pool, k + 1, j, &right, depth + 1);
+    }
+
+    multiply_rect(&left, &right, out);
+}
+
+// Function to evaluate the chain in the optimal order; result must hold p[0] x p[n-1] elements
+void execute_chain_plan(const ChainPlan *plan, const Matrix inputs[], Matrix *result) {
+    int n = plan->n;
+    if (n == 2) {
+        memcpy(result->data, inputs[0].data, (size_t)inputs[0].rows * inputs[0].cols * sizeof(double));
+        return;
+    }
+
+    double **pool = malloc((plan->slotCount + 1) * sizeof(double *));
+    for (int i = 0; i < plan->slotCount; i++)
+        pool[i] = malloc(plan->slotSize[i] * sizeof(double));
+
+    evaluate_subtree(plan, inputs, pool, 1, n - 1, result, 0);
+
+    for (int i = 0; i < plan->slotCount; i++)
+        free(pool[i]);
+    free(pool);
+}
+
+// Function to evaluate the chain strictly left to right: ((A1 A2) A3) ...
+void multiply_chain_naive(int p[], int n, const Matrix inputs[], Matrix *result) {
+    if (n == 2) {
+        memcpy(result->data, inputs[0].data, (size_t)p[0] * p[1] * sizeof(double));
+        return;
+    }
+
+    size_t maxSize = 0;
+    for (int j = 2; j < n; j++)
+        if ((size_t)p[0] * p[j] > maxSize)
+            maxSize = (size_t)p[0] * p[j];
+    double *buf[2] = {malloc(maxSize * sizeof(double)), malloc(maxSize * sizeof(double))};
+
+    Matrix acc = inputs[0];
+    for (int j = 1; j < n - 1; j++) {
+        Matrix next = {p[0], p[j + 1], (j == n - 2) ? result->data : buf[j % 2]};
+        multiply_rect(&acc, &inputs[j], &next);
+        acc = next;
+    }
+
+    free(buf[0]);
+    free(buf[1]);
+}
+
+// Function to measure wall-clock time in milliseconds (clock() would sum CPU time across threads)
+static double wall_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Function to compare optimal-order execution against the naive order for one chain
+void benchmark_chain(int p[], int n) {
+    int s[n][n];
+    long long cost = matrix_chain_order(p, n, s);
+    long long naiveCost = 0;
+    for (int j = 2; j < n; j++)
+        naiveCost += (long long)p[0] * p[j - 1] * p[j];
+
+    Matrix inputs[n - 1];
+    for (int i = 0; i < n - 1; i++) {
+        inputs[i].rows = p[i];
+        inputs[i].cols = p[i + 1];
+        inputs[i].data = malloc((size_t)p[i] * p[i + 1] * sizeof(double));
+        for (size_t e = 0; e < (size_t)p[i] * p[i + 1]; e++)
+            inputs[i].data[e] = (double)(rand() % 10) / 10.0;
+    }
+    Matrix optimal = {p[0], p[n - 1], malloc((size_t)p[0] * p[n - 1] * sizeof(double))};
+    Matrix naive = {p[0], p[n - 1], malloc((size_t)p[0] * p[n - 1] * sizeof(double))};
+
+    ChainPlan plan;
+    build_chain_plan(&plan, p, n, s);
+    size_t poolElems = 0;
+    for (int i = 0; i < plan.slotCount; i++)
+        poolElems += plan.slotSize[i];
+
+    double start = wall_time_ms();
+    for (int r = 0; r < BENCH_REPEAT; r++)
+        execute_chain_plan(&plan, inputs, &optimal);
+    double optimalTime = (wall_time_ms() - start) / BENCH_REPEAT;
+
+    start = wall_time_ms();
+    for (int r = 0; r < BENCH_REPEAT; r++)
+        multiply_chain_naive(p, n, inputs, &naive);
+    double naiveTime = (wall_time_ms() - start) / BENCH_REPEAT;
+
+    // Check that both orders produce the same product
+    double maxDiff = 0;
+    for (size_t e = 0; e < (size_t)p[0] * p[n - 1]; e++) {
+        double diff = fabs(optimal.data[e] - naive.data[e]) / (fabs(naive.data[e]) + 1.0);
+        if (diff > maxDiff)
+            maxDiff = diff;
+    }
+
+    printf("Matrices: %d, Pool buffers: %d (%zu elements)\n", n - 1, plan.slotCount, poolElems);
+    printf("Optimal order: %lld multiplications, %.3f ms\n", cost, optimalTime);
+    printf("Left-to-right: %lld multiplications, %.3f ms\n", naiveCost, naiveTime);
+    printf("Speedup: %.2fx, Results %s\n\n", naiveTime / optimalTime, maxDiff < 1e-9 ? "match" : "DIFFER");
+
+    free_chain_plan(&plan);
+    for (int i = 0; i < n - 1; i++)
+        free(inputs[i].data);
+    free(optimal.data);
+    free(naive.data);
 }
 
 // Main function
@@ -62,9 +314,29 @@ int main() {
     // Matrix dimensions: A1(30x35), A2(35x15), A3(15x5), A4(5x10), A5(10x20), A6(20x25)
     int p[] = {30, 35, 15, 5, 10, 20, 25};  // Array of matrix dimensions
     int n = sizeof(p) / sizeof(p[0]);  // Number of matrices is n-1
+    int s[n][n];  // Table to store split points
 
     // Call the function to calculate the minimum multiplications and print the result
-    matrix_chain_order(p, n);
+    printf("Minimum number of multiplications is: %lld\n", matrix_chain_order(p, n, s));
+
+    // Output the optimal parenthesization
+    printf("Optimal parenthesization: ");
+    char name = '1';  // Start naming matrices as A1, A2, ...
+    print_optimal_parens(1, n - 1, n, s, &name);
+    printf("\n\n");
+
+    // Execute the plans on real matrices and compare with the left-to-right order
+    srand(time(NULL));
+    int scaled[] = {300, 350, 150, 50, 100, 200, 250};
+    int tall[] = {1000, 20, 800, 30, 900, 40, 700, 50, 600};
+    int random[16];
+    for (int i = 0; i < 16; i++)
+        random[i] = 20 + rand() % 400;
+
+    benchmark_chain(p, n);
+    benchmark_chain(scaled, sizeof(scaled) / sizeof(scaled[0]));
+    benchmark_chain(tall, sizeof(tall) / sizeof(tall[0]));
+    benchmark_chain(random, sizeof(random) / sizeof(random[0]));
 
     return 0;
 }
\ No newline at end of file
@@ -1,15 +1,243 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define INF INT_MAX
 #define REPEAT 10000  // Increase number of repetitions for better timing
+#define DIST_INF LLONG_MAX  // Unreachable distance for the CSR algorithms
+#define HEAP_ARITY 4        // Children per node in the indexed heap
+#define BENCH_DEGREE 4      // Out-degree of the generated benchmark graphs
+#define BENCH_MAX_WEIGHT 1000
+#define EDGE_BLOCK 256      // Edges whose candidate distances are computed together in Bellman-Ford
+#define ALT_LANDMARKS 8       // Landmarks chosen for ALT lower bounds
+#define P2P_QUERIES 200       // Point-to-point queries per benchmark run
+#define CACHE_CAPACITY 16     // Shortest-path trees kept by the SSSP cache
+#define CACHE_MAX_PENDING 4096 // Beyond this many weight changes a stale tree is rebuilt, not repaired
+#define DELTA_MAX_BUCKETS 4096 // Cyclic delta-stepping buckets per thread; a smaller delta is raised to fit
+#define FW_INF 0x3FFFFFFF    // All-pairs "no path": INF + INF still fits in an int, so no overflow checks
+#define FW_BLOCK 64          // Tile size of the blocked Floyd-Warshall
+#define GRAPH_MAGIC "CSRGRAPH"
+#define GRAPH_VERSION 1
+
+// Structure to represent a graph in compressed sparse row form
+// The out-edges of u are targets[offsets[u] .. offsets[u+1]-1] with matching weights
+typedef struct {
+    int V;
+    long long E;
+    long long *offsets;
+    int *targets;
+    int *weights;
+    void *mapping;        // Non-NULL when the arrays point into a memory-mapped graph file
+    size_t mappingSize;
+} CSRGraph;
+
+// Header of the binary CSR file. It is followed by offsets[V+1] (int64), targets[E] (int32)
+// and weights[E] (int32), so the arrays can be used in place after mmap.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t V;
+    int64_t E;
+} GraphFileHeader;
+
+// Edges parsed from one chunk of a text graph file
+typedef struct {
+    const char *begin;
+    const char *end;
+    bool dimacs;        // DIMACS "a u v w" lines (1-based) instead of "u v [w]" (0-based)
+    int *src, *dst, *weight;
+    long long count, capacity;
+    long long maxVertex;
+    const char *maxVertexLine; // Line holding maxVertex, for error messages
+    long long declaredV; // From a DIMACS "p sp V E" line, -1 if none in this chunk
+    const char *badLine; // First line with a negative or too large vertex id, NULL if none
+} ParseChunk;
+
+// Structure to represent an edge list as a structure of arrays
+typedef struct {
+    int V;
+    long long E;
+    int *src;
+    int *dst;
+    int *weight;
+} EdgeList;
+
+// Growable array of vertex ids
+typedef struct {
+    int *data;
+    int size;
+    int capacity;
+} IntVector;
+
+// Relaxation request sent to the thread owning vertex v in delta-stepping
+typedef struct {
+    int v;
+    int u;
+    long long d;
+} RelaxRequest;
+
+typedef struct {
+    RelaxRequest *data;
+    int size;
+    int capacity;
+} RequestVector;
+
+// Shared state of a delta-stepping run. Vertex v is owned by thread v % threads:
+// only the owner writes dist[v] and parent[v] and keeps v in its buckets.
+typedef struct {
+    const CSRGraph *g;
+    int threads;
+    int delta;
+    int numBuckets;              // Cyclic bucket slots per thread
+    long long *dist;
+    int *parent;
+    IntVector *buckets;          // buckets[t * numBuckets + slot]
+    RequestVector *requests;     // requests[from * threads + owner]
+    long long *frontierMark;     // Round in which v last joined its owner's frontier
+    long long *settledMark;      // Bucket (+1) in which v was last settled
+    int *active;                 // Per-thread flag: frontier non-empty this round
+    long long *nextBucket;       // Per-thread smallest non-empty bucket
+    pthread_barrier_t barrier;
+    pthread_mutex_t start;       // Held until threads is final (some workers may fail to start)
+} DeltaSteppingState;
+
+typedef struct {
+    DeltaSteppingState *state;
+    int id;
+} DeltaSteppingWorker;
+
+// Shared state of a blocked Floyd-Warshall run over an n x n padded matrix
+typedef struct {
+    int *d;
+    int n;                  // Padded size, a multiple of FW_BLOCK
+    int threads;
+    pthread_barrier_t barrier;
+    pthread_mutex_t start;  // Held until threads is final (some workers may fail to start)
+} FloydWarshallState;
+
+typedef struct {
+    FloydWarshallState *state;
+    int id;
+} FloydWarshallWorker;
+
+// Structure to represent an indexed d-ary min-heap of vertices keyed on a distance array
+typedef struct {
+    int size;
+    int *heap;              // heap[i] = vertex at heap position i
+    int *pos;               // pos[v] = heap position of v, -1 if not in the heap
+    const long long *key;   // Keys are read from the caller's distance array
+} IndexedHeap;
+
+// Reusable buffers for point-to-point queries. Entries whose stamp differs from the current
+// query id are treated as unreached, so a query costs only the vertices it touches.
+typedef struct {
+    int V;
+    int query;
+    int *stampF, *stampB;       // Forward / backward reached stamps
+    long long *distF, *distB;
+    long long *keyF;            // A* keys: distF + lower bound
+    int *stampH;                // Lower bound cache stamps
+    long long *bound;
+    IndexedHeap heapF, heapB;
+} PointQueryWorkspace;
+
+// ALT landmarks with their distances, stored vertex-major so one vertex's bounds share a cache line:
+// fromLandmark[v * count + i] = d(L_i, v), toLandmark[v * count + i] = d(v, L_i)
+typedef struct {
+    int count;
+    int V;
+    int *ids;
+    long long *fromLandmark;
+    long long *toLandmark;
+} Landmarks;
+
+// One cached shortest-path tree, valid for graph version `version`
+typedef struct {
+    int source;
+    long long version;
+    long long lastUse;
+    long long *dist;
+    int *parent;
+} CachedTree;
+
+// Weight change recorded so stale trees can be repaired
+typedef struct {
+    long long version;      // Graph version the change produced
+    long long edge;         // CSR index of the changed edge
+} EdgeUpdate;
+
+// Cache of shortest-path trees keyed by (graph version, source). Weight changes go through
+// ssspCacheSetWeight so the reverse graph and update log stay in step with the graph.
+typedef struct {
+    CSRGraph *g;
+    CSRGraph *rg;               // Reverse graph for in-edge scans during repair
+    long long *reverseIndex;    // reverseIndex[k] = index in rg of forward edge k
+    int *edgeSource;            // edgeSource[k] = tail of forward edge k
+    long long version;
+    CachedTree entries[CACHE_CAPACITY];
+    int count;
+    long long useClock;
+    EdgeUpdate *log;
+    long long logStart, logSize, logCapacity;
+    int *affected;              // Stamp of the repair that marked a vertex as affected
+    int repairStamp;
+    int *stack;
+    int *affectedList;          // Vertices marked by the current repair
+    int affectedCount;
+    IndexedHeap heap;
+    long long hits, misses, repairs;
+} SSSPCache;
+
 int minDistance(int dist[], bool sptSet[], int V);
 void dijkstra(int graph[20][20], int src, int V);
 void bellmanFord(int graph[20][3], int V, int E, int src);
 double calculateExecutionTimeDijkstra(void (*func)(int[][20], int, int), int graph[20][20], int src, int V);
 double calculateExecutionTimeBellmanFord(void (*func)(int[][3], int, int, int), int graph[20][3], int V, int E, int src);
+CSRGraph *createCSRGraph(int V, long long E, const int src[], const int dst[], const int weight[]);
+CSRGraph *csrFromMatrix(int graph[20][20], int V);
+CSRGraph *generateRandomCSR(int V, int degree, int maxWeight);
+void freeCSRGraph(CSRGraph *g);
+void heapInit(IndexedHeap *h, int V, const long long key[]);
+void heapFree(IndexedHeap *h);
+void heapPushOrDecrease(IndexedHeap *h, int v);
+int heapPopMin(IndexedHeap *h);
+int dijkstraCSR(const CSRGraph *g, int src, long long dist[], int parent[]);
+void printShortestPaths(const long long dist[], const int parent[], int V);
+EdgeList *edgeListFromCSR(const CSRGraph *g);
+void freeEdgeList(EdgeList *g);
+int extractNegativeCycle(const int parent[], int V, int start, int cycle[]);
+int bellmanFordEdges(const EdgeList *g, int src, long long dist[], int parent[], int cycle[], int *passes);
+int spfaCSR(const CSRGraph *g, int src, long long dist[], int parent[], int cycle[]);
+int chooseDelta(const CSRGraph *g);
+int bellmanFordCSR(const CSRGraph *g, int src, long long dist[], int parent[], int cycle[], int *passes);
+CSRGraph *loadGraphText(const char *path, int threads);
+CSRGraph *reverseCSRGraph(const CSRGraph *g);
+void ssspCacheInit(SSSPCache *c, CSRGraph *g);
+void ssspCacheFree(SSSPCache *c);
+void ssspCacheSetWeight(SSSPCache *c, long long edge, int weight);
+const long long *ssspCacheQuery(SSSPCache *c, int src, const int **parent);
+CSRGraph *generateGridCSR(int rows, int cols, int maxWeight);
+void initPointQuery(PointQueryWorkspace *ws, int V);
+void freePointQuery(PointQueryWorkspace *ws);
+long long bidirectionalDijkstra(const CSRGraph *g, const CSRGraph *rg, PointQueryWorkspace *ws, int s, int t, int *settled);
+Landmarks *selectLandmarks(const CSRGraph *g, const CSRGraph *rg, int count);
+void freeLandmarks(Landmarks *lm);
+long long altQuery(const CSRGraph *g, const Landmarks *lm, PointQueryWorkspace *ws, int s, int t, int *settled);
+void allPairsFromMatrix(int graph[20][20], int V, int dist[]);
+void floydWarshallBlocked(int dist[], int V, int threads);
+int saveGraphBinary(const CSRGraph *g, const char *path);
+CSRGraph *mapGraphBinary(const char *path);
+void deltaStepping(const CSRGraph *g, int src, long long dist[], int parent[], int delta, int threads);
 
 // Function to find the vertex with the minimum distance
 int minDistance(int dist[], bool sptSet[], int V) {
@@ -51,13 +279,18 @@ void bellmanFord(int graph[20][3], int V, int E, int src) {
     dist[src] = 0;
 
     for (int i = 1; i <= V - 1; i++) {
+        bool updated = false;
         for (int j = 0; j < E; j++) {
             int u = graph[j][0];
             int v = graph[j][1];
             int weight = graph[j][2];
-            if (dist[u] != INF && dist[u] + weight < dist[v])
+            if (dist[u] != INF && dist[u] + weight < dist[v]) {
                 dist[v] = dist[u] + weight;
+                updated = true;
+            }
         }
+        if (!updated)  // Distances are final once a pass changes nothing
+            break;
     }
 }
 
@@ -83,6 +316,1440 @@ double calculateExecutionTimeBellmanFord(void (*func)(int[][3], int, int, int),
     return ((double)(end - start)) / CLOCKS_PER_SEC * 1000 / REPEAT; // Average Time in ms
 }
 
+// ==================== CSR Graph ====================
+// Function to build a CSR graph from an edge list (counting sort by source vertex)
+CSRGraph *createCSRGraph(int V, long long E, const int src[], const int dst[], const int weight[]) {
+    CSRGraph *g = malloc(sizeof(CSRGraph));
+    g->V = V;
+    g->E = E;
+    g->mapping = NULL;
+    g->mappingSize = 0;
+    g->offsets = calloc(V + 1, sizeof(long long));
+    g->targets = malloc((E > 0 ? E : 1) * sizeof(int));
+    g->weights = malloc((E > 0 ? E : 1) * sizeof(int));
+
+    for (long long e = 0; e < E; e++)
+        g->offsets[src[e] + 1]++;
+    for (int u = 0; u < V; u++)
+        g->offsets[u + 1] += g->offsets[u];
+
+    long long *next = malloc((V > 0 ? V : 1) * sizeof(long long));
+    memcpy(next, g->offsets, V * sizeof(long long));
+    for (long long e = 0; e < E; e++) {
+        long long k = next[src[e]]++;
+        g->targets[k] = dst[e];
+        g->weights[k] = weight[e];
+    }
+    free(next);
+    return g;
+}
+
+// Function to convert an adjacency matrix (0 = no edge) to CSR
+CSRGraph *csrFromMatrix(int graph[20][20], int V) {
+    int src[400], dst[400], weight[400];
+    int E = 0;
+    for (int u = 0; u < V; u++)
+        for (int v = 0; v < V; v++)
+            if (graph[u][v]) {
+                src[E] = u;
+                dst[E] = v;
+                weight[E] = graph[u][v];
+                E++;
+            }
+    return createCSRGraph(V, E, src, dst, weight);
+}
+
+// Simple xorshift generator so large benchmark graphs are cheap to build
+static unsigned long long rngState = 88172645463325252ULL;
+static unsigned long long randomNext(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// Function to generate a random sparse graph with a fixed out-degree directly in CSR form
+// A ring edge u -> u+1 keeps every vertex reachable from vertex 0
+CSRGraph *generateRandomCSR(int V, int degree, int maxWeight) {
+    CSRGraph *g = malloc(sizeof(CSRGraph));
+    g->V = V;
+    g->E = (long long)V * degree;
+    g->mapping = NULL;
+    g->mappingSize = 0;
+    g->offsets = malloc((V + 1) * sizeof(long long));
+    g->targets = malloc(g->E * sizeof(int));
+    g->weights = malloc(g->E * sizeof(int));
+
+    for (int u = 0; u <= V; u++)
+        g->offsets[u] = (long long)u * degree;
+    for (int u = 0; u < V; u++) {
+        long long k = g->offsets[u];
+        g->targets[k] = (u + 1) % V;
+        g->weights[k] = 1 + randomNext() % maxWeight;
+        for (int d = 1; d < degree; d++) {
+            g->targets[k + d] = randomNext() % V;
+            g->weights[k + d] = 1 + randomNext() % maxWeight;
+        }
+    }
+    return g;
+}
+
+void freeCSRGraph(CSRGraph *g) {
+    if (g->mapping) {
+        munmap(g->mapping, g->mappingSize);
+    } else {
+        free(g->offsets);
+        free(g->targets);
+        free(g->weights);
+    }
+    free(g);
+}
+
+// ==================== Indexed Heap ====================
+void heapInit(IndexedHeap *h, int V, const long long key[]) {
+    h->size = 0;
+    h->heap = malloc(V * sizeof(int));
+    h->pos = malloc(V * sizeof(int));
+    h->key = key;
+    for (int v = 0; v < V; v++)
+        h->pos[v] = -1;
+}
+
+void heapFree(IndexedHeap *h) {
+    free(h->heap);
+    free(h->pos);
+}
+
+// Function to move the vertex at heap position i up while its key is smaller than its parent's
+static void heapSiftUp(IndexedHeap *h, int i) {
+    int v = h->heap[i];
+    long long k = h->key[v];
+    while (i > 0) {
+        int parent = (i - 1) / HEAP_ARITY;
+        int pv = h->heap[parent];
+        if (h->key[pv] <= k)
+            break;
+        h->heap[i] = pv;
+        h->pos[pv] = i;
+        i = parent;
+    }
+    h->heap[i] = v;
+    h->pos[v] = i;
+}
+
+// Function to move the vertex at heap position i down to its smallest child until ordered
+static void heapSiftDown(IndexedHeap *h, int i) {
+    int v = h->heap[i];
+    long long k = h->key[v];
+    for (;;) {
+        int first = i * HEAP_ARITY + 1;
+        if (first >= h->size)
+            break;
+        int last = first + HEAP_ARITY < h->size ? first + HEAP_ARITY : h->size;
+        int best = first;
+        for (int c = first + 1; c < last; c++)
+            if (h->key[h->heap[c]] < h->key[h->heap[best]])
+                best = c;
+        if (h->key[h->heap[best]] >= k)
+            break;
+        h->heap[i] = h->heap[best];
+        h->pos[h->heap[i]] = i;
+        i = best;
+    }
+    h->heap[i] = v;
+    h->pos[v] = i;
+}
+
+// Function to insert v, or restore order after its key decreased
+void heapPushOrDecrease(IndexedHeap *h, int v) {
+    if (h->pos[v] < 0) {
+        h->heap[h->size] = v;
+        h->pos[v] = h->size++;
+    }
+    heapSiftUp(h, h->pos[v]);
+}
+
+// Function to remove and return the vertex with the smallest key
+int heapPopMin(IndexedHeap *h) {
+    int v = h->heap[0];
+    h->pos[v] = -1;
+    if (--h->size > 0) {
+        h->heap[0] = h->heap[h->size];
+        heapSiftDown(h, 0);
+    }
+    return v;
+}
+
+// ==================== Heap-based Dijkstra ====================
+// Dijkstra's algorithm on a CSR graph with an indexed heap and decrease-key
+// Fills dist (DIST_INF if unreachable) and parent (-1 for the source and unreachable vertices)
+// Returns the number of settled vertices
+int dijkstraCSR(const CSRGraph *g, int src, long long dist[], int parent[]) {
+    IndexedHeap h;
+    heapInit(&h, g->V, dist);
+    for (int v = 0; v < g->V; v++) {
+        dist[v] = DIST_INF;
+        parent[v] = -1;
+    }
+    dist[src] = 0;
+    heapPushOrDecrease(&h, src);
+
+    int settled = 0;
+    while (h.size > 0) {
+        int u = heapPopMin(&h);
+        settled++;
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            int v = g->targets[k];
+            long long nd = dist[u] + g->weights[k];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                heapPushOrDecrease(&h, v);
+            }
+        }
+    }
+
+    heapFree(&h);
+    return settled;
+}
+
+// Function to print the distance and parent arrays returned by dijkstraCSR
+void printShortestPaths(const long long dist[], const int parent[], int V) {
+    printf("Vertex\tDistance\tParent\n");
+    for (int v = 0; v < V; v++) {
+        if (dist[v] == DIST_INF)
+            printf("%d\tINF\t\t-\n", v);
+        else
+            printf("%d\t%lld\t\t%d\n", v, dist[v], parent[v]);
+    }
+}
+
+// ==================== Bellman-Ford and SPFA ====================
+// Function to convert a CSR graph to a structure-of-arrays edge list
+EdgeList *edgeListFromCSR(const CSRGraph *g) {
+    EdgeList *el = malloc(sizeof(EdgeList));
+    el->V = g->V;
+    el->E = g->E;
+    el->src = malloc((g->E > 0 ? g->E : 1) * sizeof(int));
+    el->dst = malloc((g->E > 0 ? g->E : 1) * sizeof(int));
+    el->weight = malloc((g->E > 0 ? g->E : 1) * sizeof(int));
+    for (int u = 0; u < g->V; u++)
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++)
+            el->src[k] = u;
+    memcpy(el->dst, g->targets, g->E * sizeof(int));
+    memcpy(el->weight, g->weights, g->E * sizeof(int));
+    return el;
+}
+
+void freeEdgeList(EdgeList *g) {
+    free(g->src);
+    free(g->dst);
+    free(g->weight);
+    free(g);
+}
+
+// Function to recover a negative cycle from the parent array, starting at a vertex that was
+// still relaxable. Walking V parents is guaranteed to land on the cycle.
+// Returns the cycle length (0 if the walk ran off the tree), vertices written in path order
+int extractNegativeCycle(const int parent[], int V, int start, int cycle[]) {
+    int v = start;
+    for (int i = 0; i < V; i++) {
+        if (parent[v] < 0)
+            return 0;
+        v = parent[v];
+    }
+
+    int len = 0;
+    int u = v;
+    do {
+        cycle[len++] = u;
+        u = parent[u];
+    } while (u != v && len < V);
+
+    // Parents point backwards; reverse so the cycle reads along edge direction
+    for (int i = 0; i < len / 2; i++) {
+        int t = cycle[i];
+        cycle[i] = cycle[len - 1 - i];
+        cycle[len - 1 - i] = t;
+    }
+    return len;
+}
+
+// Bellman-Ford on a structure-of-arrays edge list
+// Each block of edges first computes its candidate distances in a branch-free loop the compiler
+// can vectorize, then applies the improvements. Stops early once a pass makes no update.
+// Returns the length of a negative cycle reachable from src written to cycle (0 if none)
+int bellmanFordEdges(const EdgeList *g, int src, long long dist[], int parent[], int cycle[], int *passes) {
+    long long cand[EDGE_BLOCK];
+    for (int v = 0; v < g->V; v++) {
+        dist[v] = DIST_INF;
+        parent[v] = -1;
+    }
+    dist[src] = 0;
+
+    int pass;
+    int lastUpdated = -1;
+    for (pass = 1; pass <= g->V; pass++) {
+        lastUpdated = -1;
+        for (long long base = 0; base < g->E; base += EDGE_BLOCK) {
+            int len = g->E - base < EDGE_BLOCK ? (int)(g->E - base) : EDGE_BLOCK;
+            const int *es = g->src + base, *ed = g->dst + base, *ew = g->weight + base;
+
+            for (int e = 0; e < len; e++) {
+                long long du = dist[es[e]];
+                cand[e] = du == DIST_INF ? DIST_INF : du + ew[e];
+            }
+            for (int e = 0; e < len; e++) {
+                if (cand[e] < dist[ed[e]]) {
+                    dist[ed[e]] = cand[e];
+                    parent[ed[e]] = es[e];
+                    lastUpdated = ed[e];
+                }
+            }
+        }
+        if (lastUpdated < 0)
+            break;
+    }
+    if (passes)
+        *passes = pass > g->V ? g->V : pass;
+
+    // An update in pass V means some shortest path would need V edges: a negative cycle
+    if (lastUpdated >= 0)
+        return extractNegativeCycle(parent, g->V, lastUpdated, cycle);
+    return 0;
+}
+
+// Bellman-Ford driven directly by a CSR graph (e.g. a memory-mapped one): each pass walks the
+// vertices in order and relaxes their out-edges, so dist[u] is loaded once per vertex.
+// Same early exit and negative-cycle reporting as bellmanFordEdges
+int bellmanFordCSR(const CSRGraph *g, int src, long long dist[], int parent[], int cycle[], int *passes) {
+    for (int v = 0; v < g->V; v++) {
+        dist[v] = DIST_INF;
+        parent[v] = -1;
+    }
+    dist[src] = 0;
+
+    int pass;
+    int lastUpdated = -1;
+    for (pass = 1; pass <= g->V; pass++) {
+        lastUpdated = -1;
+        for (int u = 0; u < g->V; u++) {
+            long long du = dist[u];
+            if (du == DIST_INF)
+                continue;
+            for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+                int v = g->targets[k];
+                if (du + g->weights[k] < dist[v]) {
+                    dist[v] = du + g->weights[k];
+                    parent[v] = u;
+                    lastUpdated = v;
+                }
+            }
+        }
+        if (lastUpdated < 0)
+            break;
+    }
+    if (passes)
+        *passes = pass > g->V ? g->V : pass;
+
+    if (lastUpdated >= 0)
+        return extractNegativeCycle(parent, g->V, lastUpdated, cycle);
+    return 0;
+}
+
+// Shortest Path Faster Algorithm: queue-based Bellman-Ford with the small-label-first heuristic
+// (a vertex whose label beats the queue front jumps the queue). A vertex relaxed V times
+// signals a negative cycle. Returns the cycle length written to cycle (0 if none)
+int spfaCSR(const CSRGraph *g, int src, long long dist[], int parent[], int cycle[]) {
+    int V = g->V;
+    int *queue = malloc((V + 1) * sizeof(int));
+    int *relaxCount = calloc(V, sizeof(int));
+    bool *inQueue = calloc(V, sizeof(bool));
+    int head = 0, count = 0;
+    int cycleLen = 0;
+
+    for (int v = 0; v < V; v++) {
+        dist[v] = DIST_INF;
+        parent[v] = -1;
+    }
+    dist[src] = 0;
+    queue[0] = src;
+    count = 1;
+    inQueue[src] = true;
+
+    while (count > 0 && cycleLen == 0) {
+        int u = queue[head];
+        head = (head + 1) % (V + 1);
+        count--;
+        inQueue[u] = false;
+
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            int v = g->targets[k];
+            long long nd = dist[u] + g->weights[k];
+            if (nd >= dist[v])
+                continue;
+            dist[v] = nd;
+            parent[v] = u;
+            if (++relaxCount[v] >= V) {
+                cycleLen = extractNegativeCycle(parent, V, v, cycle);
+                if (cycleLen > 0)
+                    break;
+            }
+            if (!inQueue[v]) {
+                inQueue[v] = true;
+                if (count > 0 && nd < dist[queue[head]]) {
+                    head = (head + V) % (V + 1);   // Small label first: push to the front
+                    queue[head] = v;
+                } else {
+                    queue[(head + count) % (V + 1)] = v;
+                }
+                count++;
+            }
+        }
+    }
+
+    free(queue);
+    free(relaxCount);
+    free(inQueue);
+    return cycleLen;
+}
+
+// ==================== Parallel Delta-Stepping ====================
+static void intVectorPush(IntVector *vec, int x) {
+    if (vec->size == vec->capacity) {
+        vec->capacity = vec->capacity ? vec->capacity * 2 : 16;
+        vec->data = realloc(vec->data, vec->capacity * sizeof(int));
+    }
+    vec->data[vec->size++] = x;
+}
+
+static void requestVectorPush(RequestVector *vec, int v, int u, long long d) {
+    if (vec->size == vec->capacity) {
+        vec->capacity = vec->capacity ? vec->capacity * 2 : 64;
+        vec->data = realloc(vec->data, vec->capacity * sizeof(RelaxRequest));
+    }
+    vec->data[vec->size++] = (RelaxRequest){v, u, d};
+}
+
+// Function to pick delta from the graph: the maximum weight divided by the average out-degree,
+// so a vertex has about one light edge per unit of delta (Meyer and Sanders' Theta(1/d) rule)
+int chooseDelta(const CSRGraph *g) {
+    int maxWeight = 1;
+    for (long long k = 0; k < g->E; k++)
+        if (g->weights[k] > maxWeight)
+            maxWeight = g->weights[k];
+    double avgDegree = g->V > 0 ? (double)g->E / g->V : 1;
+    int delta = (int)(maxWeight / (avgDegree > 1 ? avgDegree : 1));
+    return delta > 0 ? delta : 1;
+}
+
+// Function to turn the out-edges of the listed vertices into requests for their owners.
+// light selects edges with weight <= delta, otherwise the heavy edges are relaxed.
+static void deltaGenerateRequests(DeltaSteppingState *S, int id, const IntVector *list, bool light) {
+    const CSRGraph *g = S->g;
+    for (int i = 0; i < list->size; i++) {
+        int u = list->data[i];
+        long long du = S->dist[u];
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            int w = g->weights[k];
+            if ((w <= S->delta) != light)
+                continue;
+            int v = g->targets[k];
+            int owner = v % S->threads;
+            long long nd = du + w;
+            if (owner == id && nd >= S->dist[v])
+                continue;  // Only our own vertices can be filtered without a race
+            requestVectorPush(&S->requests[id * S->threads + owner], v, u, nd);
+        }
+    }
+}
+
+// Function to apply every request addressed to this thread and rebucket improved vertices
+static void deltaApplyRequests(DeltaSteppingState *S, int id) {
+    for (int from = 0; from < S->threads; from++) {
+        RequestVector *req = &S->requests[from * S->threads + id];
+        for (int i = 0; i < req->size; i++) {
+            RelaxRequest r = req->data[i];
+            if (r.d < S->dist[r.v]) {
+                S->dist[r.v] = r.d;
+                S->parent[r.v] = r.u;
+                intVectorPush(&S->buckets[id * S->numBuckets + (r.d / S->delta) % S->numBuckets], r.v);
+            }
+        }
+        req->size = 0;
+    }
+}
+
+static void *deltaSteppingWorker(void *arg) {
+    DeltaSteppingWorker *worker = (DeltaSteppingWorker *)arg;
+    DeltaSteppingState *S = worker->state;
+    int id = worker->id;
+    IntVector frontier = {NULL, 0, 0}, settled = {NULL, 0, 0};
+    long long cur = 0, round = 0;
+    pthread_mutex_lock(&S->start);
+    pthread_mutex_unlock(&S->start);
+
+    for (;;) {
+        // Light phase: keep emptying bucket cur until no thread reinserts into it
+        for (;;) {
+            IntVector *bucket = &S->buckets[id * S->numBuckets + cur % S->numBuckets];
+            frontier.size = 0;
+            round++;
+            for (int i = 0; i < bucket->size; i++) {
+                int v = bucket->data[i];
+                if (S->dist[v] / S->delta != cur || S->frontierMark[v] == round)
+                    continue;  // Stale entry or duplicate
+                S->frontierMark[v] = round;
+                intVectorPush(&frontier, v);
+                if (S->settledMark[v] != cur + 1) {
+                    S->settledMark[v] = cur + 1;
+                    intVectorPush(&settled, v);
+                }
+            }
+            bucket->size = 0;
+
+            S->active[id] = frontier.size > 0;
+            pthread_barrier_wait(&S->barrier);
+            bool any = false;
+            for (int t = 0; t < S->threads; t++)
+                any = any || S->active[t];
+            if (!any)
+                break;
+
+            deltaGenerateRequests(S, id, &frontier, true);
+            pthread_barrier_wait(&S->barrier);
+            deltaApplyRequests(S, id);
+            pthread_barrier_wait(&S->barrier);
+        }
+
+        // Heavy phase: heavy edges of everything settled in this bucket can only reach later buckets
+        deltaGenerateRequests(S, id, &settled, false);
+        pthread_barrier_wait(&S->barrier);
+        deltaApplyRequests(S, id);
+        settled.size = 0;
+
+        long long next = LLONG_MAX;
+        for (int k = 1; k < S->numBuckets; k++) {
+            if (S->buckets[id * S->numBuckets + (cur + k) % S->numBuckets].size > 0) {
+                next = cur + k;
+                break;
+            }
+        }
+        S->nextBucket[id] = next;
+        pthread_barrier_wait(&S->barrier);
+        long long minNext = LLONG_MAX;
+        for (int t = 0; t < S->threads; t++)
+            if (S->nextBucket[t] < minNext)
+                minNext = S->nextBucket[t];
+        if (minNext == LLONG_MAX)
+            break;
+        cur = minNext;
+    }
+
+    free(frontier.data);
+    free(settled.data);
+    return NULL;
+}
+
+// Delta-stepping single-source shortest paths (non-negative weights) on the given number of threads.
+// Vertices are bucketed by dist / delta; each bucket is settled by rounds of light-edge relaxations
+// followed by one round of heavy edges. Threads exchange relaxations through per-thread request
+// buffers so every dist entry has a single writer. delta <= 0 picks it with chooseDelta; a delta
+// so small that one relaxation could reach more than DELTA_MAX_BUCKETS buckets ahead is raised.
+// Distances are identical to dijkstraCSR; parents may differ where shortest paths tie.
+void deltaStepping(const CSRGraph *g, int src, long long dist[], int parent[], int delta, int threads) {
+    DeltaSteppingState S;
+    int maxWeight = 1;
+    for (long long k = 0; k < g->E; k++)
+        if (g->weights[k] > maxWeight)
+            maxWeight = g->weights[k];
+
+    S.g = g;
+    S.threads = threads > 0 ? threads : 1;
+    S.delta = delta > 0 ? delta : chooseDelta(g);
+    if (S.delta < maxWeight / (DELTA_MAX_BUCKETS - 2) + 1)
+        S.delta = maxWeight / (DELTA_MAX_BUCKETS - 2) + 1;
+    // A relaxation from bucket cur lands at most ceil(maxWeight / delta) buckets ahead
+    S.numBuckets = (maxWeight - 1) / S.delta + 2;
+    S.dist = dist;
+    S.parent = parent;
+    S.buckets = calloc((size_t)S.threads * S.numBuckets, sizeof(IntVector));
+    S.requests = calloc((size_t)S.threads * S.threads, sizeof(RequestVector));
+    S.frontierMark = calloc(g->V, sizeof(long long));
+    S.settledMark = calloc(g->V, sizeof(long long));
+    S.active = calloc(S.threads, sizeof(int));
+    S.nextBucket = calloc(S.threads, sizeof(long long));
+
+    for (int v = 0; v < g->V; v++) {
+        dist[v] = DIST_INF;
+        parent[v] = -1;
+    }
+    dist[src] = 0;
+
+    // Workers wait on start, so if a thread cannot be created the run shrinks to the ones that were
+    // (vertex ownership and the barrier count depend on threads); the caller is always worker 0
+    pthread_t tids[S.threads];
+    DeltaSteppingWorker workers[S.threads];
+    for (int t = 0; t < S.threads; t++) {
+        workers[t].state = &S;
+        workers[t].id = t;
+    }
+    pthread_mutex_init(&S.start, NULL);
+    pthread_mutex_lock(&S.start);
+    int started = 1;
+    while (started < S.threads && pthread_create(&tids[started], NULL, deltaSteppingWorker, &workers[started]) == 0)
+        started++;
+    S.threads = started;
+    pthread_barrier_init(&S.barrier, NULL, S.threads);
+    intVectorPush(&S.buckets[(src % S.threads) * S.numBuckets], src);
+    pthread_mutex_unlock(&S.start);
+
+    deltaSteppingWorker(&workers[0]);
+    for (int t = 1; t < S.threads; t++)
+        pthread_join(tids[t], NULL);
+
+    pthread_barrier_destroy(&S.barrier);
+    pthread_mutex_destroy(&S.start);
+    for (int i = 0; i < S.threads * S.numBuckets; i++)
+        free(S.buckets[i].data);
+    for (int i = 0; i < S.threads * S.threads; i++)
+        free(S.requests[i].data);
+    free(S.buckets);
+    free(S.requests);
+    free(S.frontierMark);
+    free(S.settledMark);
+    free(S.active);
+    free(S.nextBucket);
+}
+
+// ==================== Point-to-Point Queries ====================
+// Function to build the reverse graph (every edge u -> v becomes v -> u)
+CSRGraph *reverseCSRGraph(const CSRGraph *g) {
+    int *src = malloc((g->E > 0 ? g->E : 1) * sizeof(int));
+    for (int u = 0; u < g->V; u++)
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++)
+            src[k] = u;
+    CSRGraph *rg = createCSRGraph(g->V, g->E, g->targets, src, g->weights);
+    free(src);
+    return rg;
+}
+
+// Function to generate a road-like grid graph: each cell links to its 4 neighbours with random weights
+CSRGraph *generateGridCSR(int rows, int cols, int maxWeight) {
+    int V = rows * cols;
+    long long maxE = 4LL * V;
+    int *src = malloc(maxE * sizeof(int));
+    int *dst = malloc(maxE * sizeof(int));
+    int *weight = malloc(maxE * sizeof(int));
+    long long E = 0;
+    int dr[4] = {-1, 1, 0, 0}, dc[4] = {0, 0, -1, 1};
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            for (int d = 0; d < 4; d++) {
+                int nr = r + dr[d], nc = c + dc[d];
+                if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+                    continue;
+                src[E] = r * cols + c;
+                dst[E] = nr * cols + nc;
+                weight[E] = 1 + randomNext() % maxWeight;
+                E++;
+            }
+        }
+    }
+    CSRGraph *g = createCSRGraph(V, E, src, dst, weight);
+    free(src);
+    free(dst);
+    free(weight);
+    return g;
+}
+
+void initPointQuery(PointQueryWorkspace *ws, int V) {
+    ws->V = V;
+    ws->query = 0;
+    ws->stampF = calloc(V, sizeof(int));
+    ws->stampB = calloc(V, sizeof(int));
+    ws->stampH = calloc(V, sizeof(int));
+    ws->distF = malloc(V * sizeof(long long));
+    ws->distB = malloc(V * sizeof(long long));
+    ws->keyF = malloc(V * sizeof(long long));
+    ws->bound = malloc(V * sizeof(long long));
+    heapInit(&ws->heapF, V, ws->distF);
+    heapInit(&ws->heapB, V, ws->distB);
+}
+
+void freePointQuery(PointQueryWorkspace *ws) {
+    free(ws->stampF);
+    free(ws->stampB);
+    free(ws->stampH);
+    free(ws->distF);
+    free(ws->distB);
+    free(ws->keyF);
+    free(ws->bound);
+    heapFree(&ws->heapF);
+    heapFree(&ws->heapB);
+}
+
+// Function to empty a heap that a query left non-empty, touching only its remaining entries
+static void heapClear(IndexedHeap *h) {
+    for (int i = 0; i < h->size; i++)
+        h->pos[h->heap[i]] = -1;
+    h->size = 0;
+}
+
+// Function to relax the out-edges of u on one side of a bidirectional search and update the best
+// meeting distance with any neighbour the other side has already reached
+static void bidirectionalScan(const CSRGraph *g, IndexedHeap *heap, int *stamp, long long *dist,
+                              const int *otherStamp, const long long *otherDist, int query, int u, long long *best) {
+    for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+        int v = g->targets[k];
+        long long nd = dist[u] + g->weights[k];
+        if (stamp[v] != query || nd < dist[v]) {
+            stamp[v] = query;
+            dist[v] = nd;
+            heapPushOrDecrease(heap, v);
+        }
+        if (otherStamp[v] == query && nd + otherDist[v] < *best)
+            *best = nd + otherDist[v];
+    }
+}
+
+// Bidirectional Dijkstra from s forwards and from t backwards over the reverse graph rg.
+// Each step expands the side with the smaller queue; the search stops once the two queue minima
+// together reach the best meeting distance, at which point no shorter s-t path can remain.
+// Returns d(s, t) (DIST_INF if unreachable) and the number of settled vertices
+long long bidirectionalDijkstra(const CSRGraph *g, const CSRGraph *rg, PointQueryWorkspace *ws, int s, int t, int *settled) {
+    int q = ++ws->query;
+    ws->heapF.key = ws->distF;
+    ws->stampF[s] = q;
+    ws->distF[s] = 0;
+    heapPushOrDecrease(&ws->heapF, s);
+    ws->stampB[t] = q;
+    ws->distB[t] = 0;
+    heapPushOrDecrease(&ws->heapB, t);
+
+    long long best = (s == t) ? 0 : DIST_INF;
+    int count = 0;
+    while (ws->heapF.size > 0 && ws->heapB.size > 0) {
+        long long topF = ws->distF[ws->heapF.heap[0]];
+        long long topB = ws->distB[ws->heapB.heap[0]];
+        if (best != DIST_INF && topF + topB >= best)
+            break;
+        count++;
+        if (ws->heapF.size <= ws->heapB.size) {
+            int u = heapPopMin(&ws->heapF);
+            bidirectionalScan(g, &ws->heapF, ws->stampF, ws->distF, ws->stampB, ws->distB, q, u, &best);
+        } else {
+            int u = heapPopMin(&ws->heapB);
+            bidirectionalScan(rg, &ws->heapB, ws->stampB, ws->distB, ws->stampF, ws->distF, q, u, &best);
+        }
+    }
+
+    heapClear(&ws->heapF);
+    heapClear(&ws->heapB);
+    if (settled)
+        *settled = count;
+    return best;
+}
+
+// Function to choose landmarks by farthest selection: each new landmark is the reachable vertex
+// farthest from the ones already chosen. Stores d(L, v) and d(v, L) for every vertex.
+Landmarks *selectLandmarks(const CSRGraph *g, const CSRGraph *rg, int count) {
+    int V = g->V;
+    Landmarks *lm = malloc(sizeof(Landmarks));
+    lm->count = count;
+    lm->V = V;
+    lm->ids = malloc(count * sizeof(int));
+    lm->fromLandmark = malloc((size_t)V * count * sizeof(long long));
+    lm->toLandmark = malloc((size_t)V * count * sizeof(long long));
+
+    long long *dist = malloc(V * sizeof(long long));
+    long long *nearest = malloc(V * sizeof(long long));  // Distance to the closest chosen landmark
+    int *parent = malloc(V * sizeof(int));
+
+    // Seed with the vertex farthest from a random start
+    dijkstraCSR(g, randomNext() % V, dist, parent);
+    for (int v = 0; v < V; v++)
+        nearest[v] = dist[v];
+
+    for (int i = 0; i < count; i++) {
+        int pick = 0;
+        for (int v = 0; v < V; v++)
+            if (nearest[v] != DIST_INF && (nearest[pick] == DIST_INF || nearest[v] > nearest[pick]))
+                pick = v;
+        lm->ids[i] = pick;
+
+        dijkstraCSR(g, pick, dist, parent);
+        for (int v = 0; v < V; v++) {
+            lm->fromLandmark[(size_t)v * count + i] = dist[v];
+            if (i == 0 || dist[v] < nearest[v])
+                nearest[v] = dist[v];
+        }
+        dijkstraCSR(rg, pick, dist, parent);
+        for (int v = 0; v < V; v++)
+            lm->toLandmark[(size_t)v * count + i] = dist[v];
+    }
+
+    free(dist);
+    free(nearest);
+    free(parent);
+    return lm;
+}
+
+void freeLandmarks(Landmarks *lm) {
+    free(lm->ids);
+    free(lm->fromLandmark);
+    free(lm->toLandmark);
+    free(lm);
+}
+
+// Function to compute the ALT lower bound on d(v, t) from the triangle inequality:
+// d(v,t) >= d(L,t) - d(L,v) and d(v,t) >= d(v,L) - d(t,L) for every landmark L
+static long long altBound(const Landmarks *lm, int v, int t) {
+    const long long *fromV = lm->fromLandmark + (size_t)v * lm->count, *fromT = lm->fromLandmark + (size_t)t * lm->count;
+    const long long *toV = lm->toLandmark + (size_t)v * lm->count, *toT = lm->toLandmark + (size_t)t * lm->count;
+    long long best = 0;
+    for (int i = 0; i < lm->count; i++) {
+        if (fromV[i] != DIST_INF && fromT[i] != DIST_INF && fromT[i] - fromV[i] > best)
+            best = fromT[i] - fromV[i];
+        if (toV[i] != DIST_INF && toT[i] != DIST_INF && toV[i] - toT[i] > best)
+            best = toV[i] - toT[i];
+    }
+    return best;
+}
+
+// A* search from s to t keyed on dist + ALT lower bound (lm == NULL gives Dijkstra stopped at t).
+// The landmark bound is consistent, so every vertex is settled at most once.
+// Returns d(s, t) (DIST_INF if unreachable) and the number of settled vertices
+long long altQuery(const CSRGraph *g, const Landmarks *lm, PointQueryWorkspace *ws, int s, int t, int *settled) {
+    int q = ++ws->query;
+    ws->heapF.key = ws->keyF;
+    ws->stampF[s] = q;
+    ws->distF[s] = 0;
+    ws->keyF[s] = lm ? altBound(lm, s, t) : 0;
+    heapPushOrDecrease(&ws->heapF, s);
+
+    long long result = DIST_INF;
+    int count = 0;
+    while (ws->heapF.size > 0) {
+        int u = heapPopMin(&ws->heapF);
+        count++;
+        if (u == t) {
+            result = ws->distF[u];
+            break;
+        }
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            int v = g->targets[k];
+            long long nd = ws->distF[u] + g->weights[k];
+            if (ws->stampF[v] == q && nd >= ws->distF[v])
+                continue;
+            if (ws->stampH[v] != q) {
+                ws->stampH[v] = q;
+                ws->bound[v] = lm ? altBound(lm, v, t) : 0;
+            }
+            ws->stampF[v] = q;
+            ws->distF[v] = nd;
+            ws->keyF[v] = nd + ws->bound[v];
+            heapPushOrDecrease(&ws->heapF, v);
+        }
+    }
+
+    heapClear(&ws->heapF);
+    if (settled)
+        *settled = count;
+    return result;
+}
+
+// ==================== SSSP Cache with Incremental Repair ====================
+void ssspCacheInit(SSSPCache *c, CSRGraph *g) {
+    memset(c, 0, sizeof(SSSPCache));
+    c->g = g;
+    c->rg = reverseCSRGraph(g);
+    c->reverseIndex = malloc((g->E > 0 ? g->E : 1) * sizeof(long long));
+    c->edgeSource = malloc((g->E > 0 ? g->E : 1) * sizeof(int));
+    c->affected = calloc(g->V, sizeof(int));
+    c->stack = malloc(g->V * sizeof(int));
+    c->affectedList = malloc(g->V * sizeof(int));
+    heapInit(&c->heap, g->V, NULL);
+
+    // The reverse graph was filled in forward edge order, so walking the forward edges again
+    // with a per-vertex cursor reproduces where each one landed
+    long long *cursor = malloc((g->V + 1) * sizeof(long long));
+    memcpy(cursor, c->rg->offsets, (g->V + 1) * sizeof(long long));
+    for (int u = 0; u < g->V; u++) {
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            c->reverseIndex[k] = cursor[g->targets[k]]++;
+            c->edgeSource[k] = u;
+        }
+    }
+    free(cursor);
+}
+
+void ssspCacheFree(SSSPCache *c) {
+    for (int i = 0; i < c->count; i++) {
+        free(c->entries[i].dist);
+        free(c->entries[i].parent);
+    }
+    freeCSRGraph(c->rg);
+    free(c->reverseIndex);
+    free(c->edgeSource);
+    free(c->affected);
+    free(c->stack);
+    free(c->affectedList);
+    free(c->log);
+    heapFree(&c->heap);
+}
+
+// Function to change the weight of CSR edge `edge`, bumping the graph version
+void ssspCacheSetWeight(SSSPCache *c, long long edge, int weight) {
+    if (c->g->weights[edge] == weight)
+        return;
+    c->g->weights[edge] = weight;
+    c->rg->weights[c->reverseIndex[edge]] = weight;
+    c->version++;
+
+    if (c->logStart + c->logSize == c->logCapacity) {
+        if (c->logStart > 0) {
+            memmove(c->log, c->log + c->logStart, c->logSize * sizeof(EdgeUpdate));
+            c->logStart = 0;
+        } else {
+            c->logCapacity = c->logCapacity ? c->logCapacity * 2 : 256;
+            c->log = realloc(c->log, c->logCapacity * sizeof(EdgeUpdate));
+        }
+    }
+    c->log[c->logStart + c->logSize++] = (EdgeUpdate){c->version, edge};
+}
+
+// Function to mark the shortest-path subtree rooted at v as affected and reset its labels
+static void markSubtree(SSSPCache *c, CachedTree *t, int v) {
+    int top = 0;
+    c->affected[v] = c->repairStamp;
+    c->stack[top++] = v;
+    while (top > 0) {
+        int x = c->stack[--top];
+        t->dist[x] = DIST_INF;
+        c->affectedList[c->affectedCount++] = x;
+        for (long long k = c->g->offsets[x]; k < c->g->offsets[x + 1]; k++) {
+            int y = c->g->targets[k];
+            if (t->parent[y] == x && c->affected[y] != c->repairStamp) {
+                c->affected[y] = c->repairStamp;
+                c->stack[top++] = y;
+            }
+        }
+    }
+}
+
+// Function to bring a stale tree up to the current graph version (batch dynamic SSSP repair).
+// 1. A changed tree edge whose weight no longer explains its head's label was increased: that
+//    head's whole subtree holds underestimates, so it is marked affected and reset to INF.
+// 2. Each affected vertex takes its best label from unaffected in-neighbours.
+// 3. A changed edge that now offers a shorter path updates its head.
+// 4. Dijkstra from the vertices touched in steps 2-3 settles everything that can still improve.
+// Only the affected region and the vertices whose distance drops are visited.
+static void repairTree(SSSPCache *c, CachedTree *t) {
+    const CSRGraph *g = c->g;
+    c->repairStamp++;
+    c->affectedCount = 0;
+    c->heap.key = t->dist;
+
+    for (long long i = c->logStart; i < c->logStart + c->logSize; i++) {
+        if (c->log[i].version <= t->version)
+            continue;
+        long long k = c->log[i].edge;
+        int u = c->edgeSource[k], v = g->targets[k];
+        if (t->parent[v] != u || c->affected[v] == c->repairStamp || t->dist[u] == DIST_INF)
+            continue;
+        // Parallel edges: the tree edge is the cheapest u -> v edge
+        long long w = DIST_INF;
+        for (long long e = g->offsets[u]; e < g->offsets[u + 1]; e++)
+            if (g->targets[e] == v && g->weights[e] < w)
+                w = g->weights[e];
+        if (t->dist[u] + w > t->dist[v])
+            markSubtree(c, t, v);
+    }
+
+    for (int i = 0; i < c->affectedCount; i++) {
+        int x = c->affectedList[i];
+        t->parent[x] = -1;
+        for (long long e = c->rg->offsets[x]; e < c->rg->offsets[x + 1]; e++) {
+            int y = c->rg->targets[e];
+            if (c->affected[y] == c->repairStamp || t->dist[y] == DIST_INF)
+                continue;
+            if (t->dist[y] + c->rg->weights[e] < t->dist[x]) {
+                t->dist[x] = t->dist[y] + c->rg->weights[e];
+                t->parent[x] = y;
+            }
+        }
+        if (t->dist[x] != DIST_INF)
+            heapPushOrDecrease(&c->heap, x);
+    }
+
+    for (long long i = c->logStart; i < c->logStart + c->logSize; i++) {
+        if (c->log[i].version <= t->version)
+            continue;
+        long long k = c->log[i].edge;
+        int u = c->edgeSource[k], v = g->targets[k];
+        if (t->dist[u] != DIST_INF && t->dist[u] + g->weights[k] < t->dist[v]) {
+            t->dist[v] = t->dist[u] + g->weights[k];
+            t->parent[v] = u;
+            heapPushOrDecrease(&c->heap, v);
+        }
+    }
+
+    while (c->heap.size > 0) {
+        int u = heapPopMin(&c->heap);
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            int v = g->targets[k];
+            long long nd = t->dist[u] + g->weights[k];
+            if (nd < t->dist[v]) {
+                t->dist[v] = nd;
+                t->parent[v] = u;
+                heapPushOrDecrease(&c->heap, v);
+            }
+        }
+    }
+    t->version = c->version;
+}
+
+// Function to drop log entries that every cached tree has already absorbed
+static void trimUpdateLog(SSSPCache *c) {
+    long long oldest = c->version;
+    for (int i = 0; i < c->count; i++)
+        if (c->entries[i].version < oldest)
+            oldest = c->entries[i].version;
+    while (c->logSize > 0 && c->log[c->logStart].version <= oldest) {
+        c->logStart++;
+        c->logSize--;
+    }
+}
+
+// Function to return the distances (and optionally parents) from src for the current graph.
+// Current trees are hits, stale trees are repaired, and unknown sources are computed with
+// dijkstraCSR, evicting the least recently used tree when the cache is full.
+const long long *ssspCacheQuery(SSSPCache *c, int src, const int **parent) {
+    CachedTree *t = NULL;
+    for (int i = 0; i < c->count; i++)
+        if (c->entries[i].source == src)
+            t = &c->entries[i];
+
+    if (t && t->version == c->version) {
+        c->hits++;
+    } else if (t && c->version - t->version <= CACHE_MAX_PENDING) {
+        repairTree(c, t);
+        c->repairs++;
+    } else {
+        if (!t && c->count < CACHE_CAPACITY) {
+            t = &c->entries[c->count++];
+            t->dist = malloc(c->g->V * sizeof(long long));
+            t->parent = malloc(c->g->V * sizeof(int));
+        } else if (!t) {
+            t = &c->entries[0];
+            for (int i = 1; i < c->count; i++)
+                if (c->entries[i].lastUse < t->lastUse)
+                    t = &c->entries[i];
+        }
+        t->source = src;
+        dijkstraCSR(c->g, src, t->dist, t->parent);
+        t->version = c->version;
+        c->misses++;
+    }
+
+    t->lastUse = ++c->useClock;
+    trimUpdateLog(c);
+    if (parent)
+        *parent = t->parent;
+    return t->dist;
+}
+
+// ==================== Blocked All-Pairs Shortest Paths ====================
+// Function to convert an adjacency matrix (0 = no edge) to the all-pairs input: dist[u*V+v]
+void allPairsFromMatrix(int graph[20][20], int V, int dist[]) {
+    for (int u = 0; u < V; u++)
+        for (int v = 0; v < V; v++)
+            dist[u * V + v] = (u == v) ? 0 : (graph[u][v] ? graph[u][v] : FW_INF);
+}
+
+// Min-plus update of tile C through pivot rows [k0, k0 + FW_BLOCK): C[i][j] = min(C[i][j], A[i][k] + B[k][j]).
+// A and B may alias C (diagonal and pivot row/column tiles) - Floyd-Warshall stays correct when it
+// reads values already improved in the same k step. Row k is copied first so the compiler can see
+// it does not overlap C. A sum with an FW_INF operand stays FW_INF, otherwise a negative edge would
+// turn "no path" into a finite distance: rows with A[i][k] = FW_INF are skipped and B[k][j] = FW_INF
+// is a select, so the inner loop is still a branch-free add, blend and min that vectorizes; the
+// clones pick AVX2 at runtime.
+__attribute__((target_clones("avx2", "default")))
+static void floydWarshallTile(int *d, int n, int ci, int cj, int k0) {
+    int bk[FW_BLOCK];
+    for (int k = k0; k < k0 + FW_BLOCK; k++) {
+        memcpy(bk, d + (size_t)k * n + cj, sizeof(bk));
+        for (int i = ci; i < ci + FW_BLOCK; i++) {
+            int *c = d + (size_t)i * n + cj;
+            int aik = d[(size_t)i * n + k];
+            if (aik >= FW_INF)
+                continue;
+            for (int j = 0; j < FW_BLOCK; j++) {
+                int through = bk[j] < FW_INF ? aik + bk[j] : FW_INF;
+                c[j] = through < c[j] ? through : c[j];
+            }
+        }
+    }
+}
+
+static void *floydWarshallWorker(void *arg) {
+    FloydWarshallWorker *worker = (FloydWarshallWorker *)arg;
+    FloydWarshallState *S = worker->state;
+    int blocks = S->n / FW_BLOCK;
+    pthread_mutex_lock(&S->start);
+    pthread_mutex_unlock(&S->start);
+
+    for (int kb = 0; kb < blocks; kb++) {
+        int k0 = kb * FW_BLOCK;
+        // Phase 1: the diagonal tile depends only on itself
+        if (worker->id == 0)
+            floydWarshallTile(S->d, S->n, k0, k0, k0);
+        pthread_barrier_wait(&S->barrier);
+
+        // Phase 2: tiles in pivot row kb and pivot column kb depend on the diagonal tile
+        for (int t = worker->id; t < 2 * blocks; t += S->threads) {
+            int b = t / 2;
+            if (b == kb)
+                continue;
+            if (t % 2 == 0)
+                floydWarshallTile(S->d, S->n, k0, b * FW_BLOCK, k0);
+            else
+                floydWarshallTile(S->d, S->n, b * FW_BLOCK, k0, k0);
+        }
+        pthread_barrier_wait(&S->barrier);
+
+        // Phase 3: every other tile depends only on its pivot row and column tiles
+        for (int t = worker->id; t < blocks * blocks; t += S->threads) {
+            int bi = t / blocks, bj = t % blocks;
+            if (bi != kb && bj != kb)
+                floydWarshallTile(S->d, S->n, bi * FW_BLOCK, bj * FW_BLOCK, k0);
+        }
+        pthread_barrier_wait(&S->barrier);
+    }
+    return NULL;
+}
+
+// Cache-blocked, multithreaded Floyd-Warshall. dist is V x V row-major with FW_INF for missing
+// edges and 0 on the diagonal; on return it holds all shortest-path distances (FW_INF if none).
+// Negative edges are fine; path lengths must stay between -FW_INF and FW_INF (no negative cycles).
+void floydWarshallBlocked(int dist[], int V, int threads) {
+    FloydWarshallState S;
+    S.n = (V + FW_BLOCK - 1) / FW_BLOCK * FW_BLOCK;
+    S.threads = threads > 0 ? threads : 1;
+    S.d = aligned_alloc(64, (size_t)S.n * S.n * sizeof(int));
+    for (int i = 0; i < S.n; i++)
+        for (int j = 0; j < S.n; j++)
+            S.d[(size_t)i * S.n + j] = (i < V && j < V) ? dist[(size_t)i * V + j] : FW_INF;
+
+    // As in deltaStepping, threads that cannot be created are dropped before the barrier is sized
+    pthread_t tids[S.threads];
+    FloydWarshallWorker workers[S.threads];
+    for (int t = 0; t < S.threads; t++) {
+        workers[t].state = &S;
+        workers[t].id = t;
+    }
+    pthread_mutex_init(&S.start, NULL);
+    pthread_mutex_lock(&S.start);
+    int started = 1;
+    while (started < S.threads && pthread_create(&tids[started], NULL, floydWarshallWorker, &workers[started]) == 0)
+        started++;
+    S.threads = started;
+    pthread_barrier_init(&S.barrier, NULL, S.threads);
+    pthread_mutex_unlock(&S.start);
+
+    floydWarshallWorker(&workers[0]);
+    for (int t = 1; t < S.threads; t++)
+        pthread_join(tids[t], NULL);
+    pthread_barrier_destroy(&S.barrier);
+    pthread_mutex_destroy(&S.start);
+
+    for (int i = 0; i < V; i++)
+        for (int j = 0; j < V; j++) {
+            int x = S.d[(size_t)i * S.n + j];
+            dist[(size_t)i * V + j] = x < FW_INF ? x : FW_INF;
+        }
+    free(S.d);
+}
+
+// ==================== Graph Files ====================
+// Function to parse a (possibly negative) decimal integer, advancing *p; returns false at end of line
+static bool parseNextInt(const char **p, const char *end, long long *out) {
+    const char *c = *p;
+    while (c < end && (*c == ' ' || *c == '\t' || *c == '\r'))
+        c++;
+    if (c >= end || *c == '\n')
+        return false;
+    bool negative = false;
+    if (*c == '-') {
+        negative = true;
+        c++;
+    }
+    long long x = 0;
+    while (c < end && *c >= '0' && *c <= '9')
+        x = x * 10 + (*c++ - '0');
+    *out = negative ? -x : x;
+    *p = c;
+    return true;
+}
+
+static void *parseChunkWorker(void *arg) {
+    ParseChunk *c = (ParseChunk *)arg;
+    const char *p = c->begin;
+    while (p < c->end) {
+        const char *lineEnd = memchr(p, '\n', c->end - p);
+        if (!lineEnd)
+            lineEnd = c->end;
+
+        long long u, v, w = 1;
+        const char *q = p;
+        while (q < lineEnd && (*q == ' ' || *q == '\t'))
+            q++;
+        if (c->dimacs && q < lineEnd && *q == 'p') {
+            // "p sp V E"
+            q++;
+            while (q < lineEnd && (*q == ' ' || *q == '\t'))
+                q++;
+            while (q < lineEnd && *q != ' ' && *q != '\t')
+                q++;
+            if (parseNextInt(&q, lineEnd, &u))
+                c->declaredV = u;
+        } else if ((c->dimacs && q < lineEnd && *q == 'a') || (!c->dimacs && q < lineEnd && (*q == '-' || (*q >= '0' && *q <= '9')))) {
+            if (c->dimacs)
+                q++;
+            if (parseNextInt(&q, lineEnd, &u) && parseNextInt(&q, lineEnd, &v)) {
+                parseNextInt(&q, lineEnd, &w);
+                if (c->dimacs) {
+                    u--;
+                    v--;
+                }
+                if (u < 0 || v < 0 || u >= INT_MAX || v >= INT_MAX) {
+                    if (!c->badLine)
+                        c->badLine = p;
+                    p = lineEnd + 1;
+                    continue;
+                }
+                if (c->count == c->capacity) {
+                    c->capacity = c->capacity ? c->capacity * 2 : 1024;
+                    c->src = realloc(c->src, c->capacity * sizeof(int));
+                    c->dst = realloc(c->dst, c->capacity * sizeof(int));
+                    c->weight = realloc(c->weight, c->capacity * sizeof(int));
+                }
+                c->src[c->count] = (int)u;
+                c->dst[c->count] = (int)v;
+                c->weight[c->count] = (int)w;
+                c->count++;
+                if (u > c->maxVertex || v > c->maxVertex) {
+                    c->maxVertex = u > v ? u : v;
+                    c->maxVertexLine = p;
+                }
+            }
+        }
+        // Anything else ("c ...", "# ...", "% ...", blank) is a comment
+        p = lineEnd + 1;
+    }
+    return NULL;
+}
+
+// Function to report a malformed line of a text graph file with its 1-based line number
+static void reportGraphLine(const char *path, const char *text, const char *end, const char *line, const char *what) {
+    long long number = 1;
+    for (const char *c = text; c < line; c++)
+        number += *c == '\n';
+    const char *lineEnd = line;
+    while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r' && lineEnd - line < 80)
+        lineEnd++;
+    fprintf(stderr, "%s:%lld: %s: %.*s\n", path, number, what, (int)(lineEnd - line), line);
+}
+
+// Function to load a DIMACS .gr file or a plain "u v [w]" edge list (0-based, weight 1 if absent).
+// The file is mapped and split at line boundaries into one chunk per thread, parsed in parallel.
+// Returns NULL if the file cannot be read or an edge names a negative vertex, or for DIMACS a
+// vertex beyond the count on the "p" line
+CSRGraph *loadGraphText(const char *path, int threads) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+    size_t size = st.st_size;
+    const char *text = size ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : "";
+    close(fd);
+    if (text == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    // The first non-blank character decides the format: DIMACS files start with 'c' or 'p'
+    const char *first = text;
+    while (first < text + size && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n'))
+        first++;
+    bool dimacs = first < text + size && (*first == 'c' || *first == 'p' || *first == 'a');
+
+    if (threads < 1)
+        threads = 1;
+    ParseChunk chunks[threads];
+    pthread_t tids[threads];
+    const char *begin = text;
+    for (int t = 0; t < threads; t++) {
+        const char *end = (t == threads - 1) ? text + size : text + size / threads * (t + 1);
+        if (end < begin)
+            end = begin;
+        while (end < text + size && end > begin && end[-1] != '\n')
+            end++;
+        chunks[t] = (ParseChunk){begin, end, dimacs, NULL, NULL, NULL, 0, 0, -1, NULL, -1, NULL};
+        begin = end;
+    }
+    for (int t = 1; t < threads; t++)
+        pthread_create(&tids[t], NULL, parseChunkWorker, &chunks[t]);
+    parseChunkWorker(&chunks[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tids[t], NULL);
+
+    long long E = 0, V = 0, declaredV = -1;
+    for (int t = 0; t < threads; t++)
+        if (chunks[t].declaredV >= 0)
+            declaredV = chunks[t].declaredV;
+    const char *badLine = NULL, *badWhat = NULL;
+    for (int t = 0; t < threads && !badLine; t++) {
+        if (chunks[t].badLine) {
+            badLine = chunks[t].badLine;
+            badWhat = "invalid vertex id";
+        } else if (declaredV >= 0 && chunks[t].maxVertex >= declaredV) {
+            badLine = chunks[t].maxVertexLine;
+            badWhat = "vertex id above the count on the p line";
+        }
+    }
+    if (badLine) {
+        reportGraphLine(path, text, text + size, badLine, badWhat);
+        for (int t = 0; t < threads; t++) {
+            free(chunks[t].src);
+            free(chunks[t].dst);
+            free(chunks[t].weight);
+        }
+        if (size)
+            munmap((void *)text, size);
+        return NULL;
+    }
+    for (int t = 0; t < threads; t++) {
+        E += chunks[t].count;
+        if (chunks[t].maxVertex + 1 > V)
+            V = chunks[t].maxVertex + 1;
+    }
+    if (declaredV > V)
+        V = declaredV;
+
+    int *src = malloc((E > 0 ? E : 1) * sizeof(int));
+    int *dst = malloc((E > 0 ? E : 1) * sizeof(int));
+    int *weight = malloc((E > 0 ? E : 1) * sizeof(int));
+    long long k = 0;
+    for (int t = 0; t < threads; t++) {
+        memcpy(src + k, chunks[t].src, chunks[t].count * sizeof(int));
+        memcpy(dst + k, chunks[t].dst, chunks[t].count * sizeof(int));
+        memcpy(weight + k, chunks[t].weight, chunks[t].count * sizeof(int));
+        k += chunks[t].count;
+        free(chunks[t].src);
+        free(chunks[t].dst);
+        free(chunks[t].weight);
+    }
+    if (size)
+        munmap((void *)text, size);
+
+    CSRGraph *g = createCSRGraph((int)V, E, src, dst, weight);
+    free(src);
+    free(dst);
+    free(weight);
+    return g;
+}
+
+// Function to write a graph in the binary CSR format; returns 0 on success, -1 on error
+int saveGraphBinary(const CSRGraph *g, const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    GraphFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_MAGIC, 8);
+    header.version = GRAPH_VERSION;
+    header.V = g->V;
+    header.E = g->E;
+
+    int64_t *offsets = malloc((g->V + 1) * sizeof(int64_t));
+    for (int u = 0; u <= g->V; u++)
+        offsets[u] = g->offsets[u];
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1
+           && fwrite(offsets, sizeof(int64_t), g->V + 1, f) == (size_t)g->V + 1
+           && fwrite(g->targets, sizeof(int), g->E, f) == (size_t)g->E
+           && fwrite(g->weights, sizeof(int), g->E, f) == (size_t)g->E;
+    free(offsets);
+    if (fclose(f) != 0 || !ok) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+// Function to map a binary CSR file; nothing is parsed or copied. One pass checks that the offsets
+// run from 0 to E without decreasing and that every target is a vertex.
+// Returns NULL if the file is missing or not a valid graph file
+CSRGraph *mapGraphBinary(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+    size_t size = st.st_size;
+    void *base = size >= sizeof(GraphFileHeader) ? mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "%s: not a graph file\n", path);
+        return NULL;
+    }
+
+    const GraphFileHeader *header = base;
+    bool valid = memcmp(header->magic, GRAPH_MAGIC, 8) == 0 && header->version == GRAPH_VERSION
+              && header->V >= 0 && header->V <= INT_MAX
+              && header->E >= 0 && (uint64_t)header->E <= size / (2 * sizeof(int))
+              && sizeof(GraphFileHeader) + (header->V + 1) * sizeof(int64_t) + 2 * header->E * sizeof(int) == size;
+    CSRGraph *g = malloc(sizeof(CSRGraph));
+    if (valid) {
+        g->V = (int)header->V;
+        g->E = header->E;
+        g->offsets = (long long *)((char *)base + sizeof(GraphFileHeader));
+        g->targets = (int *)(g->offsets + g->V + 1);
+        g->weights = g->targets + g->E;
+        g->mapping = base;
+        g->mappingSize = size;
+        // One pass over the arrays, so a corrupt file cannot send the searches out of bounds
+        valid = g->offsets[0] == 0 && g->offsets[g->V] == g->E;
+        for (int u = 0; u < g->V && valid; u++)
+            valid = g->offsets[u] <= g->offsets[u + 1];
+        for (long long k = 0; k < g->E && valid; k++)
+            valid = g->targets[k] >= 0 && g->targets[k] < g->V;
+    }
+    if (!valid) {
+        fprintf(stderr, "%s: not a graph file\n", path);
+        munmap(base, size);
+        free(g);
+        return NULL;
+    }
+    return g;
+}
+
 // Test function
 void compareAlgorithms() {
     // Graphs input data for Dijkstra
@@ -143,9 +1810,519 @@ void compareAlgorithms() {
 
     printf("Dijkstra Time (ms) for Graph 3: %.5f\n", dijkstra_time_3);
     printf("Bellman-Ford Time (ms) for Graph 3: %.5f\n", bellman_time_3);
+
+    // Shortest-path trees from the CSR engine on the same graphs
+    int (*graphs[3])[20] = {graph1, graph2, graph3};
+    int vertices[3] = {4, 6, 8};
+    for (int i = 0; i < 3; i++) {
+        CSRGraph *g = csrFromMatrix(graphs[i], vertices[i]);
+        long long dist[20];
+        int parent[20];
+        dijkstraCSR(g, 0, dist, parent);
+        printf("\nCSR Dijkstra for Graph %d:\n", i + 1);
+        printShortestPaths(dist, parent, vertices[i]);
+        freeCSRGraph(g);
+    }
+
+    // All-pairs distance table for Graph 3
+    int table[8 * 8];
+    allPairsFromMatrix(graph3, 8, table);
+    floydWarshallBlocked(table, 8, 1);
+    printf("\nAll-pairs distances for Graph 3:\n");
+    for (int u = 0; u < 8; u++) {
+        for (int v = 0; v < 8; v++) {
+            if (table[u * 8 + v] == FW_INF)
+                printf("INF\t");
+            else
+                printf("%d\t", table[u * 8 + v]);
+        }
+        printf("\n");
+    }
+}
+
+// Function to measure wall-clock time in milliseconds
+static double wallTimeMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Benchmark heap-based Dijkstra on large random sparse graphs
+void benchmarkDijkstraCSR() {
+    int sizes[] = {100000, 1000000, 10000000};
+    printf("\nVertices\tEdges\t\tDijkstra CSR (ms)\tSettled/s\n");
+    for (int i = 0; i < 3; i++) {
+        CSRGraph *g = generateRandomCSR(sizes[i], BENCH_DEGREE, BENCH_MAX_WEIGHT);
+        long long *dist = malloc(g->V * sizeof(long long));
+        int *parent = malloc(g->V * sizeof(int));
+
+        double start = wallTimeMs();
+        int settled = dijkstraCSR(g, 0, dist, parent);
+        double elapsed = wallTimeMs() - start;
+        printf("%d\t%lld\t%.2f\t\t%.0f\n", g->V, g->E, elapsed, settled / (elapsed / 1000));
+
+        free(dist);
+        free(parent);
+        freeCSRGraph(g);
+    }
+}
+
+// Function to add random vertex potentials to the edge weights: w(u,v) += pot[u] - pot[v]
+// Shortest paths keep their shape, many weights turn negative, and no negative cycle appears
+static void applyPotentials(CSRGraph *g, int maxPotential) {
+    int *pot = malloc(g->V * sizeof(int));
+    for (int v = 0; v < g->V; v++)
+        pot[v] = randomNext() % maxPotential;
+    for (int u = 0; u < g->V; u++)
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++)
+            g->weights[k] += pot[u] - pot[g->targets[k]];
+    free(pot);
+}
+
+// Benchmark early-exit Bellman-Ford and SPFA on large sparse graphs, with and without negative weights
+void benchmarkBellmanFord() {
+    int sizes[] = {100000, 1000000};
+    printf("\nVertices\tWeights\t\tBF passes\tBF (ms)\t\tSPFA (ms)\tDijkstra (ms)\tAgree\n");
+    for (int i = 0; i < 2; i++) {
+        for (int negative = 0; negative <= 1; negative++) {
+            CSRGraph *g = generateRandomCSR(sizes[i], BENCH_DEGREE, BENCH_MAX_WEIGHT);
+            if (negative)
+                applyPotentials(g, BENCH_MAX_WEIGHT);
+            EdgeList *el = edgeListFromCSR(g);
+            long long *distBF = malloc(g->V * sizeof(long long));
+            long long *distSPFA = malloc(g->V * sizeof(long long));
+            int *parent = malloc(g->V * sizeof(int));
+            int *cycle = malloc(g->V * sizeof(int));
+            int passes;
+
+            double start = wallTimeMs();
+            bellmanFordEdges(el, 0, distBF, parent, cycle, &passes);
+            double bfTime = wallTimeMs() - start;
+
+            start = wallTimeMs();
+            spfaCSR(g, 0, distSPFA, parent, cycle);
+            double spfaTime = wallTimeMs() - start;
+
+            bool agree = memcmp(distBF, distSPFA, g->V * sizeof(long long)) == 0;
+            if (negative) {
+                printf("%d\tnegative\t%d\t\t%.2f\t\t%.2f\t\t-\t\t%s\n", g->V, passes, bfTime, spfaTime, agree ? "yes" : "NO");
+            } else {
+                long long *distDij = malloc(g->V * sizeof(long long));
+                start = wallTimeMs();
+                dijkstraCSR(g, 0, distDij, parent);
+                double dijTime = wallTimeMs() - start;
+                agree = agree && memcmp(distBF, distDij, g->V * sizeof(long long)) == 0;
+                printf("%d\tnon-negative\t%d\t\t%.2f\t\t%.2f\t\t%.2f\t\t%s\n", g->V, passes, bfTime, spfaTime, dijTime, agree ? "yes" : "NO");
+                free(distDij);
+            }
+
+            free(distBF);
+            free(distSPFA);
+            free(parent);
+            free(cycle);
+            freeEdgeList(el);
+            freeCSRGraph(g);
+        }
+    }
+
+    // Negative-cycle reporting: a ring 0 -> 1 -> ... -> 9 -> 0 with total weight -1
+    int src[10], dst[10], weight[10];
+    for (int i = 0; i < 10; i++) {
+        src[i] = i;
+        dst[i] = (i + 1) % 10;
+        weight[i] = (i == 9) ? -10 : 1;
+    }
+    CSRGraph *g = createCSRGraph(10, 10, src, dst, weight);
+    EdgeList *el = edgeListFromCSR(g);
+    long long dist[10];
+    int parent[10], cycle[10], passes;
+    int lenBF = bellmanFordEdges(el, 0, dist, parent, cycle, &passes);
+    printf("\nNegative cycle found by Bellman-Ford (length %d):", lenBF);
+    for (int i = 0; i < lenBF; i++)
+        printf(" %d", cycle[i]);
+    int lenSPFA = spfaCSR(g, 0, dist, parent, cycle);
+    printf("\nNegative cycle found by SPFA (length %d):", lenSPFA);
+    for (int i = 0; i < lenSPFA; i++)
+        printf(" %d", cycle[i]);
+    printf("\n");
+    freeEdgeList(el);
+    freeCSRGraph(g);
+}
+
+// Benchmark delta-stepping scaling from 1 to N threads against dijkstraCSR
+void benchmarkDeltaStepping() {
+    int sizes[] = {100000, 1000000};
+    int maxThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    for (int i = 0; i < 2; i++) {
+        CSRGraph *g = generateRandomCSR(sizes[i], BENCH_DEGREE, BENCH_MAX_WEIGHT);
+        long long *distDij = malloc(g->V * sizeof(long long));
+        long long *dist = malloc(g->V * sizeof(long long));
+        int *parent = malloc(g->V * sizeof(int));
+
+        double start = wallTimeMs();
+        dijkstraCSR(g, 0, distDij, parent);
+        double dijTime = wallTimeMs() - start;
+        printf("\nDelta-stepping on %d vertices (delta = %d), Dijkstra CSR: %.2f ms\n", g->V, chooseDelta(g), dijTime);
+        printf("Threads\tTime (ms)\tSpeedup vs 1 thread\tMatches Dijkstra\n");
+
+        double oneThread = 0;
+        for (int t = 1; t <= maxThreads; t = (t < maxThreads && t * 2 > maxThreads) ? maxThreads : t * 2) {
+            start = wallTimeMs();
+            deltaStepping(g, 0, dist, parent, 0, t);
+            double elapsed = wallTimeMs() - start;
+            if (t == 1)
+                oneThread = elapsed;
+            bool match = memcmp(dist, distDij, g->V * sizeof(long long)) == 0;
+            printf("%d\t%.2f\t\t%.2f\t\t\t%s\n", t, elapsed, oneThread / elapsed, match ? "yes" : "NO");
+        }
+
+        free(distDij);
+        free(dist);
+        free(parent);
+        freeCSRGraph(g);
+    }
+}
+
+// Benchmark blocked Floyd-Warshall on dense clusters against running Dijkstra from every vertex
+void benchmarkAllPairs() {
+    int sizes[] = {512, 1000, 2000};
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1)
+        threads = 1;
+    printf("\nVertices\tFloyd-Warshall (ms)\tV x Dijkstra (ms)\tMatch\n");
+
+    for (int s = 0; s < 3; s++) {
+        int V = sizes[s];
+        int *table = malloc((size_t)V * V * sizeof(int));
+        int *esrc = malloc((size_t)V * V * sizeof(int));
+        int *edst = malloc((size_t)V * V * sizeof(int));
+        int *ew = malloc((size_t)V * V * sizeof(int));
+        long long E = 0;
+
+        // Dense cluster: each ordered pair is an edge with probability 1/4
+        for (int u = 0; u < V; u++) {
+            for (int v = 0; v < V; v++) {
+                table[(size_t)u * V + v] = (u == v) ? 0 : FW_INF;
+                if (u != v && randomNext() % 4 == 0) {
+                    int w = 1 + randomNext() % BENCH_MAX_WEIGHT;
+                    table[(size_t)u * V + v] = w;
+                    esrc[E] = u;
+                    edst[E] = v;
+                    ew[E] = w;
+                    E++;
+                }
+            }
+        }
+        CSRGraph *g = createCSRGraph(V, E, esrc, edst, ew);
+
+        double start = wallTimeMs();
+        floydWarshallBlocked(table, V, threads);
+        double fwTime = wallTimeMs() - start;
+
+        long long *dist = malloc(V * sizeof(long long));
+        int *parent = malloc(V * sizeof(int));
+        bool match = true;
+        start = wallTimeMs();
+        for (int src = 0; src < V; src++) {
+            dijkstraCSR(g, src, dist, parent);
+            for (int v = 0; v < V; v++)
+                match = match && (dist[v] == DIST_INF ? FW_INF : dist[v]) == table[(size_t)src * V + v];
+        }
+        double dijTime = wallTimeMs() - start;
+        printf("%d\t\t%.2f\t\t\t%.2f\t\t\t%s\n", V, fwTime, dijTime, match ? "yes" : "NO");
+
+        free(dist);
+        free(parent);
+        free(table);
+        free(esrc);
+        free(edst);
+        free(ew);
+        freeCSRGraph(g);
+    }
 }
 
-int main() {
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to print mean settled vertices and p50/p99 latency for one query mode
+static void reportQueries(const char *name, const long long settled[], double latency[], int count) {
+    long long total = 0;
+    for (int i = 0; i < count; i++)
+        total += settled[i];
+    qsort(latency, count, sizeof(double), compareDoubles);
+    printf("%-24s%lld\t\t%.4f\t\t%.4f\n", name, total / count, latency[count / 2], latency[count * 99 / 100]);
+}
+
+// Benchmark point-to-point queries on a road-like grid: Dijkstra stopped at the target,
+// bidirectional Dijkstra and ALT A*, all checked against the full shortest-path tree
+void benchmarkPointQueries() {
+    CSRGraph *g = generateGridCSR(700, 700, BENCH_MAX_WEIGHT);
+    CSRGraph *rg = reverseCSRGraph(g);
+    PointQueryWorkspace ws;
+    initPointQuery(&ws, g->V);
+
+    double start = wallTimeMs();
+    Landmarks *lm = selectLandmarks(g, rg, ALT_LANDMARKS);
+    double prepTime = wallTimeMs() - start;
+
+    long long *dist = malloc(g->V * sizeof(long long));
+    int *parent = malloc(g->V * sizeof(int));
+    start = wallTimeMs();
+    dijkstraCSR(g, 0, dist, parent);
+    double fullTime = wallTimeMs() - start;
+
+    printf("\nPoint-to-point queries on a %d-vertex grid (%d landmarks, preprocessing %.2f ms)\n", g->V, ALT_LANDMARKS, prepTime);
+    printf("Full Dijkstra tree: %d settled, %.4f ms\n", g->V, fullTime);
+    printf("Mode\t\t\tSettled/query\tp50 (ms)\tp99 (ms)\n");
+
+    int *sources = malloc(P2P_QUERIES * sizeof(int));
+    int *targets = malloc(P2P_QUERIES * sizeof(int));
+    long long *expected = malloc(P2P_QUERIES * sizeof(long long));
+    long long *settled = malloc(P2P_QUERIES * sizeof(long long));
+    double *latency = malloc(P2P_QUERIES * sizeof(double));
+    for (int i = 0; i < P2P_QUERIES; i++) {
+        sources[i] = randomNext() % g->V;
+        targets[i] = randomNext() % g->V;
+    }
+
+    bool match = true;
+    for (int mode = 0; mode < 3; mode++) {
+        for (int i = 0; i < P2P_QUERIES; i++) {
+            int count;
+            long long d;
+            start = wallTimeMs();
+            if (mode == 0)
+                d = altQuery(g, NULL, &ws, sources[i], targets[i], &count);
+            else if (mode == 1)
+                d = bidirectionalDijkstra(g, rg, &ws, sources[i], targets[i], &count);
+            else
+                d = altQuery(g, lm, &ws, sources[i], targets[i], &count);
+            latency[i] = wallTimeMs() - start;
+            settled[i] = count;
+            if (mode == 0)
+                expected[i] = d;
+            else
+                match = match && d == expected[i];
+        }
+        reportQueries(mode == 0 ? "Dijkstra (stop at t)" : mode == 1 ? "Bidirectional Dijkstra" : "ALT A*", settled, latency, P2P_QUERIES);
+    }
+
+    // Spot-check the early-stopped search against full trees
+    for (int i = 0; i < 5; i++) {
+        dijkstraCSR(g, sources[i], dist, parent);
+        match = match && dist[targets[i]] == expected[i];
+    }
+    printf("All modes agree: %s\n", match ? "yes" : "NO");
+
+    free(sources);
+    free(targets);
+    free(expected);
+    free(settled);
+    free(latency);
+    free(dist);
+    free(parent);
+    freeLandmarks(lm);
+    freePointQuery(&ws);
+    freeCSRGraph(rg);
+    freeCSRGraph(g);
+}
+
+// Benchmark the SSSP cache: repeated queries on an unchanged graph, then queries interleaved
+// with random weight increases and decreases, comparing repair latency with a full rerun
+void benchmarkSSSPCache() {
+    CSRGraph *g = generateGridCSR(500, 500, BENCH_MAX_WEIGHT);
+    SSSPCache cache;
+    ssspCacheInit(&cache, g);
+    long long *dist = malloc(g->V * sizeof(long long));
+    int *parent = malloc(g->V * sizeof(int));
+    int sources[8];
+    for (int i = 0; i < 8; i++)
+        sources[i] = randomNext() % g->V;
+
+    double start = wallTimeMs();
+    for (int i = 0; i < REPEAT; i++)
+        ssspCacheQuery(&cache, sources[i % 8], NULL);
+    double cachedTime = (wallTimeMs() - start) / REPEAT;
+
+    int rounds = 200;
+    double repairTime = 0, fullTime = 0;
+    bool match = true;
+    for (int i = 0; i < rounds; i++) {
+        long long edge = randomNext() % g->E;
+        int w = g->weights[edge];
+        int nw = (randomNext() % 2) ? w * 2 : (w / 2 > 0 ? w / 2 : 1);
+        ssspCacheSetWeight(&cache, edge, nw);
+
+        int src = sources[i % 8];
+        start = wallTimeMs();
+        const long long *cached = ssspCacheQuery(&cache, src, NULL);
+        repairTime += wallTimeMs() - start;
+
+        start = wallTimeMs();
+        dijkstraCSR(g, src, dist, parent);
+        fullTime += wallTimeMs() - start;
+        match = match && memcmp(cached, dist, g->V * sizeof(long long)) == 0;
+    }
+
+    printf("\nSSSP cache on a %d-vertex grid (%d sources)\n", g->V, 8);
+    printf("Unchanged graph: %.5f ms per query over %d queries\n", cachedTime, REPEAT);
+    printf("After each weight change: repair %.4f ms vs full Dijkstra %.4f ms\n", repairTime / rounds, fullTime / rounds);
+    printf("Hits: %lld, Misses: %lld, Repairs: %lld, Repaired trees match: %s\n",
+           cache.hits, cache.misses, cache.repairs, match ? "yes" : "NO");
+
+    free(dist);
+    free(parent);
+    ssspCacheFree(&cache);
+    freeCSRGraph(g);
+}
+
+// Function to write a graph as DIMACS text (used to produce benchmark input)
+static void writeGraphDimacs(const CSRGraph *g, const char *path) {
+    FILE *f = fopen(path, "w");
+    fprintf(f, "c generated by lab6\np sp %d %lld\n", g->V, g->E);
+    for (int u = 0; u < g->V; u++)
+        for (long long k = g->offsets[u]; k < g->offsets[u + 1]; k++)
+            fprintf(f, "a %d %d %d\n", u + 1, g->targets[k] + 1, g->weights[k]);
+    fclose(f);
+}
+
+// Benchmark text parsing, binary conversion and mmap loading
+void benchmarkGraphFiles() {
+    const char *textPath = "lab6_bench.gr";
+    const char *binPath = "lab6_bench.csr";
+    int maxThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    CSRGraph *orig = generateRandomCSR(1000000, BENCH_DEGREE, BENCH_MAX_WEIGHT);
+    writeGraphDimacs(orig, textPath);
+    struct stat st;
+    stat(textPath, &st);
+    printf("\nLoading a %.1f MB DIMACS file (%d vertices, %lld edges)\n", st.st_size / 1e6, orig->V, orig->E);
+    printf("Threads\tParse (ms)\n");
+
+    CSRGraph *parsed = NULL;
+    for (int t = 1; t <= maxThreads; t = (t < maxThreads && t * 2 > maxThreads) ? maxThreads : t * 2) {
+        if (parsed)
+            freeCSRGraph(parsed);
+        double start = wallTimeMs();
+        parsed = loadGraphText(textPath, t);
+        printf("%d\t%.2f\n", t, wallTimeMs() - start);
+    }
+
+    double start = wallTimeMs();
+    saveGraphBinary(parsed, binPath);
+    double saveTime = wallTimeMs() - start;
+    start = wallTimeMs();
+    CSRGraph *mapped = mapGraphBinary(binPath);
+    double mapTime = wallTimeMs() - start;
+    printf("Binary save: %.2f ms, mmap load: %.4f ms\n", saveTime, mapTime);
+
+    long long *distDij = malloc(mapped->V * sizeof(long long));
+    long long *distBF = malloc(mapped->V * sizeof(long long));
+    long long *distOrig = malloc(mapped->V * sizeof(long long));
+    int *parent = malloc(mapped->V * sizeof(int));
+    int *cycle = malloc(mapped->V * sizeof(int));
+    int passes;
+
+    dijkstraCSR(orig, 0, distOrig, parent);
+    start = wallTimeMs();
+    dijkstraCSR(mapped, 0, distDij, parent);
+    double dijTime = wallTimeMs() - start;
+    start = wallTimeMs();
+    bellmanFordCSR(mapped, 0, distBF, parent, cycle, &passes);
+    double bfTime = wallTimeMs() - start;
+    bool match = memcmp(distDij, distOrig, mapped->V * sizeof(long long)) == 0
+              && memcmp(distBF, distOrig, mapped->V * sizeof(long long)) == 0;
+    printf("On the mapped graph: Dijkstra %.2f ms, Bellman-Ford %.2f ms (%d passes), Results %s\n",
+           dijTime, bfTime, passes, match ? "match" : "DIFFER");
+
+    free(distDij);
+    free(distBF);
+    free(distOrig);
+    free(parent);
+    free(cycle);
+    freeCSRGraph(mapped);
+    freeCSRGraph(parsed);
+    freeCSRGraph(orig);
+    remove(textPath);
+    remove(binPath);
+}
+
+// Function to run Bellman-Ford from vertex 0 on a graph file given on the command line and print its
+// paths; when no weight is negative Dijkstra is run as well and its distances checked against them.
+// Binary CSR files are mapped; anything else is parsed as DIMACS or an edge list.
+// Returns 0 on success, 1 if the file cannot be loaded or has no vertices.
+int runGraphFile(const char *path) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    char magic[8] = {0};
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    bool binary = fread(magic, 1, 8, f) == 8 && memcmp(magic, GRAPH_MAGIC, 8) == 0;
+    fclose(f);
+
+    CSRGraph *g = binary ? mapGraphBinary(path) : loadGraphText(path, threads > 0 ? threads : 1);
+    if (!g)
+        return 1;
+    if (g->V == 0) {
+        fprintf(stderr, "%s: graph has no vertices\n", path);
+        freeCSRGraph(g);
+        return 1;
+    }
+
+    long long *dist = malloc(g->V * sizeof(long long));
+    int *parent = malloc(g->V * sizeof(int));
+    int *cycle = malloc(g->V * sizeof(int));
+    int passes;
+    printf("Graph %s: %d vertices, %lld edges\n", path, g->V, g->E);
+    int cycleLen = bellmanFordCSR(g, 0, dist, parent, cycle, &passes);
+    if (cycleLen > 0) {
+        printf("Negative cycle:");
+        for (int i = 0; i < cycleLen; i++)
+            printf(" %d", cycle[i]);
+        printf("\n");
+    } else {
+        printShortestPaths(dist, parent, g->V < 20 ? g->V : 20);
+        bool negativeWeight = false;
+        for (long long k = 0; k < g->E && !negativeWeight; k++)
+            negativeWeight = g->weights[k] < 0;
+        if (negativeWeight) {
+            printf("Negative weights: Dijkstra skipped\n");
+        } else {
+            long long *distDij = malloc(g->V * sizeof(long long));
+            dijkstraCSR(g, 0, distDij, cycle);
+            bool match = memcmp(distDij, dist, g->V * sizeof(long long)) == 0;
+            printf("Dijkstra distances %s\n", match ? "match" : "DIFFER");
+            free(distDij);
+        }
+    }
+
+    free(dist);
+    free(parent);
+    free(cycle);
+    freeCSRGraph(g);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        return runGraphFile(argv[1]);
+    }
     compareAlgorithms();
+    benchmarkDijkstraCSR();
+    benchmarkBellmanFord();
+    benchmarkDeltaStepping();
+    benchmarkAllPairs();
+    benchmarkPointQueries();
+    benchmarkSSSPCache();
+    benchmarkGraphFiles();
     return 0;
 }
\ No newline at end of file
@@ -1,6 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#define ROW_BLOCK 8  // Capacities updated together in the vectorized DP row update
+#define MITM_MAX_ITEMS 40          // Largest n for meet-in-the-middle (2^20 subsets per half)
+#define DENSE_MAX_CELLS 200000000LL // Largest n * W the dense DP is allowed to take on
 
 // Structure to represent an item with value and weight
 struct Item {
@@ -15,9 +25,79 @@ struct SelectedItem {
     int weight;
 };
 
+// Structure to hold the DP buffers of one solver thread, grown on demand and reused across instances
+struct KnapsackWorkspace {
+    int *rows;
+    int rowCapacity;
+    int rowLevels;
+    char *take;
+    struct SelectedItem *selected;
+    int itemCapacity;
+};
+
+// Structure to describe one instance of a batch
+struct KnapsackInstance {
+    struct Item *items;
+    int n;
+    int W;
+};
+
+// Structure to hold one batch result; the chosen 1-based item indices are
+// selectedIndex[selectedOffset .. selectedOffset + selectedCount - 1]
+struct BatchResult {
+    int dpValue;
+    int greedyValue;
+    int selectedCount;
+    long long selectedOffset;
+};
+
+// Structure to pair an instance with its estimated cost n * W for the batch ordering
+struct InstanceCost {
+    long long cost;
+    int index;
+};
+
+// Structure shared by the batch worker threads
+struct BatchState {
+    struct KnapsackInstance *instances;
+    struct InstanceCost *order; // Instances, most expensive first
+    int count;
+    atomic_int next;            // Next position in order to hand out
+    struct BatchResult *results;
+    int *selectedIndex;
+};
+
+// Engines the automatic solver can choose from
+enum KnapsackEngine {
+    ENGINE_DENSE,    // Row DP with a checkpointed traceback, O(W log n) memory
+    ENGINE_SPARSE,   // Dominance-pruned (weight, value) Pareto lists
+    ENGINE_MITM      // Meet in the middle over the two halves of the items
+};
+
+// Structure to represent one non-dominated partial solution of the sparse DP
+struct ParetoState {
+    long long weight;
+    long long value;
+};
+
+// Structure to represent one subset of half the items in meet-in-the-middle
+struct HalfSubset {
+    long long weight;
+    long long value;
+    unsigned int mask;
+};
+
 int compare(const void* a, const void* b);
 int greedyKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount) ;
 int dpKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount);
+int dpKnapsackLinear(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount);
+int dpKnapsackInWorkspace(struct KnapsackWorkspace *ws, struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount);
+void freeKnapsackWorkspace(struct KnapsackWorkspace *ws);
+void solveKnapsackBatch(struct KnapsackInstance instances[], int count, int threads, struct BatchResult results[], int selectedIndex[]);
+void writeBatchJSON(FILE *out, const struct BatchResult results[], const int selectedIndex[], int count);
+int sparseKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount);
+int meetInTheMiddleKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount);
+int autoKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount, enum KnapsackEngine *engine);
 void printSelectedItems(struct SelectedItem selected[], int count, const char* approach);
 
 // Comparator function to sort items by descending value-to-weight ratio
@@ -104,6 +184,411 @@ int dpKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[]
     return dp[n][W]; // Maximum value that can be obtained
 }
 
+// ==================== Linear-Memory Dynamic Programming ====================
+// Function to add one item to a DP row: row[w] = max(row[w], row[w - weight] + value), w from C down.
+// Walking down keeps the row O(W). Blocks of ROW_BLOCK capacities only read capacities at least
+// `weight` below themselves, so when weight >= ROW_BLOCK a block's reads never see its own writes
+// and the two fixed-width loops compile to vector loads, adds and maxes.
+static void knapsackRowUpdate(int row[], int C, int weight, int value) {
+    int w = C;
+    if (weight >= ROW_BLOCK) {
+        for (; w - ROW_BLOCK + 1 >= weight; w -= ROW_BLOCK) {
+            int base = w - ROW_BLOCK + 1;
+            int cand[ROW_BLOCK];
+            for (int l = 0; l < ROW_BLOCK; l++)
+                cand[l] = row[base + l - weight] + value;
+            for (int l = 0; l < ROW_BLOCK; l++)
+                row[base + l] = cand[l] > row[base + l] ? cand[l] : row[base + l];
+        }
+    }
+    for (; w >= weight; w--) {
+        int cand = row[w - weight] + value;
+        if (cand > row[w])
+            row[w] = cand;
+    }
+}
+
+// Function to build the row after items[lo..hi) from the row before them, on capacities 0..C.
+// Capacity 0 is reset after every item so the rows match dpKnapsack's table, which keeps
+// dp[i][0] = 0 even when an item weighs nothing
+static void knapsackExtendRow(const int from[], int to[], struct Item items[], int lo, int hi, int C) {
+    memcpy(to, from, (C + 1) * sizeof(int));
+    for (int i = lo; i < hi; i++) {
+        if (items[i].weight <= C)
+            knapsackRowUpdate(to, C, items[i].weight, items[i].value);
+        to[0] = 0;
+    }
+}
+
+// Checkpointed traceback: replays dpKnapsack's walk from row hi with capacity C down to row lo,
+// given base = row lo of dpKnapsack's table on capacities 0..C. Item i is left out whenever
+// row i+1 equals row i at the current capacity, exactly as in dpKnapsack, so the two pick the
+// same items. Row mid is rebuilt into scratch and the upper half is walked first; the lower half
+// then reuses scratch, so only one row per recursion level is live (O(W log n) memory, O(nW log n)
+// time). Chosen items are flagged in take[]; returns the capacity left when row lo is reached.
+static int knapsackTraceback(struct Item items[], int lo, int hi, int C, const int base[], int scratch[], int stride, char take[]) {
+    if (hi - lo == 1) {
+        if (C == 0 || items[lo].weight > C)
+            return C;
+        int with = base[C - items[lo].weight] + items[lo].value;
+        if (with <= base[C])
+            return C;
+        take[lo] = 1;
+        return C - items[lo].weight;
+    }
+    int mid = (lo + hi) / 2;
+    knapsackExtendRow(base, scratch, items, lo, mid, C);
+    int rest = knapsackTraceback(items, mid, hi, C, scratch, scratch + stride, stride, take);
+    return knapsackTraceback(items, lo, mid, rest, base, scratch, stride, take);
+}
+
+// Function to make sure the workspace holds the traceback rows for capacity W and flags for n items
+static void reserveKnapsackWorkspace(struct KnapsackWorkspace *ws, int n, int W) {
+    // One zero row, then one row per level of knapsackTraceback's recursion
+    int levels = 1;
+    while ((1 << (levels - 1)) < n)
+        levels++;
+    if (W + 1 > ws->rowCapacity || levels > ws->rowLevels) {
+        if (W + 1 > ws->rowCapacity)
+            ws->rowCapacity = W + 1;
+        if (levels > ws->rowLevels)
+            ws->rowLevels = levels;
+        ws->rows = realloc(ws->rows, (size_t)ws->rowLevels * ws->rowCapacity * sizeof(int));
+    }
+    if (n > ws->itemCapacity) {
+        ws->itemCapacity = n;
+        ws->take = realloc(ws->take, n);
+        ws->selected = realloc(ws->selected, n * sizeof(struct SelectedItem));
+    }
+}
+
+void freeKnapsackWorkspace(struct KnapsackWorkspace *ws) {
+    free(ws->rows);
+    free(ws->take);
+    free(ws->selected);
+}
+
+// Function to solve 0/1 Knapsack with O(W log n) memory instead of an (n+1) x (W+1) table.
+// The items come from knapsackTraceback and are the ones dpKnapsack picks, in the same order
+// (highest index first); the optimum is their total value.
+int dpKnapsackLinear(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount) {
+    struct KnapsackWorkspace ws = {0};
+    int best = dpKnapsackInWorkspace(&ws, items, n, W, selected, selectedCount);
+    freeKnapsackWorkspace(&ws);
+    return best;
+}
+
+// Same as dpKnapsackLinear, taking its buffers from a reusable workspace
+int dpKnapsackInWorkspace(struct KnapsackWorkspace *ws, struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount) {
+    *selectedCount = 0;
+    if (n == 0 || W <= 0)
+        return 0;
+    reserveKnapsackWorkspace(ws, n, W);
+
+    // Rows are laid out with stride W + 1 from the start of the buffer; row 0 of the table is all zeros
+    memset(ws->rows, 0, (W + 1) * sizeof(int));
+    memset(ws->take, 0, n);
+    knapsackTraceback(items, 0, n, W, ws->rows, ws->rows + (W + 1), W + 1, ws->take);
+    int best = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        if (ws->take[i]) {
+            selected[*selectedCount].index = i + 1;
+            selected[*selectedCount].value = items[i].value;
+            selected[*selectedCount].weight = items[i].weight;
+            (*selectedCount)++;
+            best += items[i].value;
+        }
+    }
+    return best;
+}
+
+// ==================== Batch Solver ====================
+// Comparator to order instances by descending estimated cost n * W (longest job first),
+// so the big instances start early and the small ones fill the gaps at the end
+static int compareCost(const void* a, const void* b) {
+    const struct InstanceCost *x = (const struct InstanceCost *)a;
+    const struct InstanceCost *y = (const struct InstanceCost *)b;
+    if (x->cost != y->cost)
+        return (x->cost < y->cost) - (x->cost > y->cost);
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+// Worker thread: claim instances in cost order and solve them with one reused workspace
+static void *batchWorker(void *arg) {
+    struct BatchState *state = (struct BatchState *)arg;
+    struct KnapsackWorkspace ws = {0};
+    for (;;) {
+        int pos = atomic_fetch_add(&state->next, 1);
+        if (pos >= state->count)
+            break;
+        int id = state->order[pos].index;
+        struct KnapsackInstance *inst = &state->instances[id];
+        struct BatchResult *res = &state->results[id];
+        int count;
+
+        reserveKnapsackWorkspace(&ws, inst->n, inst->W);
+        res->greedyValue = greedyKnapsack(inst->items, inst->n, inst->W, ws.selected, &count);
+        res->dpValue = dpKnapsackInWorkspace(&ws, inst->items, inst->n, inst->W, ws.selected, &count);
+        res->selectedCount = count;
+        for (int i = 0; i < count; i++)
+            state->selectedIndex[res->selectedOffset + i] = ws.selected[count - 1 - i].index;
+    }
+    freeKnapsackWorkspace(&ws);
+    return NULL;
+}
+
+// Function to solve many independent instances on a pool of threads.
+// selectedIndex must have room for the total number of items over all instances.
+void solveKnapsackBatch(struct KnapsackInstance instances[], int count, int threads, struct BatchResult results[], int selectedIndex[]) {
+    struct BatchState state;
+    state.instances = instances;
+    state.count = count;
+    state.results = results;
+    state.selectedIndex = selectedIndex;
+    atomic_init(&state.next, 0);
+    state.order = malloc((count > 0 ? count : 1) * sizeof(struct InstanceCost));
+
+    long long offset = 0;
+    for (int i = 0; i < count; i++) {
+        state.order[i].cost = (long long)instances[i].n * instances[i].W;
+        state.order[i].index = i;
+        results[i].selectedOffset = offset;
+        offset += instances[i].n;
+    }
+    qsort(state.order, count, sizeof(struct InstanceCost), compareCost);
+
+    if (threads < 1)
+        threads = 1;
+    pthread_t tids[threads];
+    for (int t = 1; t < threads; t++)
+        pthread_create(&tids[t], NULL, batchWorker, &state);
+    batchWorker(&state);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tids[t], NULL);
+    free(state.order);
+}
+
+// Function to write batch results as one JSON array, one instance per line
+void writeBatchJSON(FILE *out, const struct BatchResult results[], const int selectedIndex[], int count) {
+    fprintf(out, "[\n");
+    for (int i = 0; i < count; i++) {
+        const struct BatchResult *r = &results[i];
+        fprintf(out, "{\"id\":%d,\"dp\":%d,\"greedy\":%d,\"gap\":%d,\"items\":[", i, r->dpValue, r->greedyValue, r->dpValue - r->greedyValue);
+        for (int k = 0; k < r->selectedCount; k++)
+            fprintf(out, k ? ",%d" : "%d", selectedIndex[r->selectedOffset + k]);
+        fprintf(out, "]}%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+// ==================== Large-Capacity Engines ====================
+// Function to append one selected item (1-based index) to a selection list
+static void addSelected(struct Item items[], int i, struct SelectedItem selected[], int *selectedCount) {
+    selected[*selectedCount].index = i + 1;
+    selected[*selectedCount].value = items[i].value;
+    selected[*selectedCount].weight = items[i].weight;
+    (*selectedCount)++;
+}
+
+// Function to find state (weight, value) in a Pareto list sorted by weight
+static int findParetoState(const struct ParetoState list[], long long size, long long weight, long long value) {
+    long long lo = 0, hi = size - 1;
+    while (lo <= hi) {
+        long long mid = (lo + hi) / 2;
+        if (list[mid].weight == weight)
+            return list[mid].value == value;
+        if (list[mid].weight < weight)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return 0;
+}
+
+// Sparse DP over Pareto lists: after each item only the (weight, value) pairs not dominated by a
+// lighter-or-equal pair of at least the same value are kept, sorted by weight with rising value.
+// The work depends on how many such states exist, not on W. Every level is kept for the traceback,
+// which walks back from the best final state exactly like dpKnapsack walks back up its table.
+int sparseKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount) {
+    *selectedCount = 0;
+    long long capacity = 1024, size = 1;
+    struct ParetoState *states = malloc(capacity * sizeof(struct ParetoState));
+    long long *levelStart = malloc((n + 2) * sizeof(long long));
+    states[0] = (struct ParetoState){0, 0};
+    levelStart[0] = 0;
+    levelStart[1] = 1;
+
+    for (int i = 0; i < n; i++) {
+        long long a = levelStart[i], b = levelStart[i], end = levelStart[i + 1];
+        long long w = items[i].weight, v = items[i].value;
+        // The merged list is at most twice as long as the previous one
+        if (size + 2 * (end - a) > capacity) {
+            while (size + 2 * (end - a) > capacity)
+                capacity *= 2;
+            states = realloc(states, capacity * sizeof(struct ParetoState));
+        }
+        long long out = size;
+        while (a < end || (b < end && states[b].weight + w <= W)) {
+            struct ParetoState cand;
+            bool fromShift = b < end && states[b].weight + w <= W
+                          && (a >= end || states[b].weight + w < states[a].weight
+                              || (states[b].weight + w == states[a].weight && states[b].value + v > states[a].value));
+            if (fromShift) {
+                cand = (struct ParetoState){states[b].weight + w, states[b].value + v};
+                b++;
+            } else {
+                cand = states[a++];
+            }
+            if (out > size && cand.value <= states[out - 1].value)
+                continue;  // Dominated by a lighter state
+            if (out > size && cand.weight == states[out - 1].weight)
+                states[out - 1] = cand;
+            else
+                states[out++] = cand;
+        }
+        levelStart[i + 2] = out;
+        size = out;
+    }
+
+    struct ParetoState cur = states[levelStart[n + 1] - 1];
+    for (int i = n - 1; i >= 0; i--) {
+        if (findParetoState(states + levelStart[i], levelStart[i + 1] - levelStart[i], cur.weight, cur.value))
+            continue;
+        addSelected(items, i, selected, selectedCount);
+        cur.weight -= items[i].weight;
+        cur.value -= items[i].value;
+    }
+
+    int best = (int)states[levelStart[n + 1] - 1].value;
+    free(states);
+    free(levelStart);
+    return best;
+}
+
+// Function to list all 2^count subsets of items[first .. first+count)
+static void enumerateHalf(struct Item items[], int first, int count, struct HalfSubset out[]) {
+    out[0] = (struct HalfSubset){0, 0, 0};
+    for (int k = 0; k < count; k++) {
+        int half = 1 << k;
+        for (int m = 0; m < half; m++) {
+            out[half + m].weight = out[m].weight + items[first + k].weight;
+            out[half + m].value = out[m].value + items[first + k].value;
+            out[half + m].mask = out[m].mask | (1u << k);
+        }
+    }
+}
+
+static int compareHalfWeight(const void* a, const void* b) {
+    const struct HalfSubset *x = a, *y = b;
+    return (x->weight > y->weight) - (x->weight < y->weight);
+}
+
+// Meet in the middle: enumerate the subsets of each half, sort the second half by weight and keep
+// the best value seen up to each weight, then match every first-half subset with the best
+// second-half subset that still fits. O(2^(n/2) n) time whatever the weights are.
+int meetInTheMiddleKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount) {
+    *selectedCount = 0;
+    int h = n / 2;
+    struct HalfSubset *left = malloc(((size_t)1 << h) * sizeof(struct HalfSubset));
+    struct HalfSubset *right = malloc(((size_t)1 << (n - h)) * sizeof(struct HalfSubset));
+    enumerateHalf(items, 0, h, left);
+    enumerateHalf(items, h, n - h, right);
+
+    long long rightCount = 1LL << (n - h);
+    qsort(right, rightCount, sizeof(struct HalfSubset), compareHalfWeight);
+    // Turn right[] into "best subset with weight <= right[k].weight"
+    for (long long k = 1; k < rightCount; k++)
+        if (right[k].value < right[k - 1].value) {
+            right[k].value = right[k - 1].value;
+            right[k].mask = right[k - 1].mask;
+        }
+
+    long long best = -1;
+    unsigned int bestLeft = 0, bestRight = 0;
+    for (long long m = 0; m < (1LL << h); m++) {
+        if (left[m].weight > W)
+            continue;
+        long long room = W - left[m].weight;
+        long long lo = 0, hi = rightCount - 1;   // right[0] is the empty subset, weight 0
+        while (lo < hi) {
+            long long mid = (lo + hi + 1) / 2;
+            if (right[mid].weight <= room)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        if (left[m].value + right[lo].value > best) {
+            best = left[m].value + right[lo].value;
+            bestLeft = left[m].mask;
+            bestRight = right[lo].mask;
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        bool taken = i < h ? (bestLeft >> i) & 1 : (bestRight >> (i - h)) & 1;
+        if (taken)
+            addSelected(items, i, selected, selectedCount);
+    }
+    free(left);
+    free(right);
+    return (int)best;
+}
+
+static int gcd(int a, int b) {
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Function to solve an instance with whichever engine should be cheapest for it.
+// Weights and capacity are first divided by the GCD of the weights (any subset weighs a multiple of
+// it, so the capacity rounds down). Then the dense DP costs n * W', meet in the middle about
+// 2^(n/2) * n for n <= MITM_MAX_ITEMS, and the sparse DP takes over when the dense table would be
+// too large - its state count never exceeds W' + 1 and usually stays far below it.
+int autoKnapsack(struct Item items[], int n, int W, struct SelectedItem selected[], int *selectedCount, enum KnapsackEngine *engine) {
+    int g = 0;
+    for (int i = 0; i < n; i++)
+        g = gcd(g, items[i].weight);
+    if (g <= 0)
+        g = 1;
+
+    struct Item *scaled = malloc((n > 0 ? n : 1) * sizeof(struct Item));
+    for (int i = 0; i < n; i++) {
+        scaled[i].value = items[i].value;
+        scaled[i].weight = items[i].weight / g;
+    }
+    int Ws = W / g;
+
+    double denseCost = (double)n * Ws;
+    double mitmCost = n <= MITM_MAX_ITEMS ? (double)(1LL << (n / 2)) * (n + 1) : 1e300;
+    enum KnapsackEngine choice;
+    if (mitmCost < denseCost)
+        choice = ENGINE_MITM;
+    else if (denseCost <= DENSE_MAX_CELLS)
+        choice = ENGINE_DENSE;
+    else
+        choice = ENGINE_SPARSE;
+
+    int best;
+    if (choice == ENGINE_MITM)
+        best = meetInTheMiddleKnapsack(scaled, n, Ws, selected, selectedCount);
+    else if (choice == ENGINE_DENSE)
+        best = dpKnapsackLinear(scaled, n, Ws, selected, selectedCount);
+    else
+        best = sparseKnapsack(scaled, n, Ws, selected, selectedCount);
+
+    // Report the original weights
+    for (int k = 0; k < *selectedCount; k++)
+        selected[k].weight = items[selected[k].index - 1].weight;
+    if (engine)
+        *engine = choice;
+    free(scaled);
+    return best;
+}
+
 // ==================== Utility Function ====================
 // Function to print the selected items
 void printSelectedItems(struct SelectedItem selected[], int count, const char* approach) {
@@ -196,7 +681,7 @@ int main() {
         // Dynamic Programming Approach
         struct SelectedItem selectedDP[sizes[d]];
         int selectedCountDP = 0;
-        int dpValue = dpKnapsack(datasets[d], sizes[d], capacities[d], selectedDP, &selectedCountDP);
+        int dpValue = dpKnapsackLinear(datasets[d], sizes[d], capacities[d], selectedDP, &selectedCountDP);
         printf("Dynamic Programming Approach:\n");
         printf("Total Value Obtained: %d\n", dpValue);
         printSelectedItems(selectedDP, selectedCountDP, "Dynamic Programming");
@@ -209,5 +694,160 @@ int main() {
         printf("=============================================\n\n");
     }
 
+    // The same five datasets through the batch API, as JSON
+    struct KnapsackInstance batch[5];
+    struct BatchResult batchResults[5];
+    int batchSelected[4 * 5];
+    for (int d = 0; d < numDatasets; d++) {
+        batch[d].items = datasets[d];
+        batch[d].n = sizes[d];
+        batch[d].W = capacities[d];
+    }
+    solveKnapsackBatch(batch, numDatasets, 1, batchResults, batchSelected);
+    printf("Batch results:\n");
+    writeBatchJSON(stdout, batchResults, batchSelected, numDatasets);
+    printf("\n");
+
+    // Batch throughput on many small random instances
+    srand(time(NULL));
+    int batchCount = 20000;
+    int maxThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (maxThreads < 1)
+        maxThreads = 1;
+    struct KnapsackInstance *many = malloc(batchCount * sizeof(struct KnapsackInstance));
+    struct BatchResult *manyResults = malloc(batchCount * sizeof(struct BatchResult));
+    long long totalItems = 0;
+    for (int i = 0; i < batchCount; i++) {
+        many[i].n = 10 + rand() % 91;
+        many[i].W = 100 + rand() % 901;
+        many[i].items = malloc(many[i].n * sizeof(struct Item));
+        for (int k = 0; k < many[i].n; k++) {
+            many[i].items[k].weight = 1 + rand() % 100;
+            many[i].items[k].value = 1 + rand() % 100;
+        }
+        totalItems += many[i].n;
+    }
+    int *manySelected = malloc(totalItems * sizeof(int));
+    printf("Batch of %d instances:\nThreads\tInstances/sec\n", batchCount);
+    for (int t = 1; t <= maxThreads; t = (t < maxThreads && t * 2 > maxThreads) ? maxThreads : t * 2) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        solveKnapsackBatch(many, batchCount, t, manyResults, manySelected);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+        printf("%d\t%.0f\n", t, batchCount / secs);
+    }
+    long long gapTotal = 0;
+    int greedyOptimal = 0;
+    for (int i = 0; i < batchCount; i++) {
+        gapTotal += manyResults[i].dpValue - manyResults[i].greedyValue;
+        greedyOptimal += manyResults[i].dpValue == manyResults[i].greedyValue;
+    }
+    printf("Greedy optimal on %d of %d instances, mean gap %.2f\n\n", greedyOptimal, batchCount, (double)gapTotal / batchCount);
+    for (int i = 0; i < batchCount; i++)
+        free(many[i].items);
+    free(many);
+    free(manyResults);
+    free(manySelected);
+
+    // Engine selection: the lab9 dataset (all weights multiples of 40) and large-capacity instances
+    const char *engineNames[] = {"dense DP", "sparse Pareto DP", "meet in the middle"};
+    struct Item lab9Items[] = {{240, 40}, {400, 80}, {480, 120}, {560, 160}, {600, 200}, {800, 240}};
+    struct SelectedItem autoSelected[200];
+    int autoCount;
+    enum KnapsackEngine engine;
+    int autoValue = autoKnapsack(lab9Items, 6, 400, autoSelected, &autoCount, &engine);
+    printf("Lab 9 dataset: value %d with %s (capacity 400 scales to 10)\n", autoValue, engineNames[engine]);
+    printSelectedItems(autoSelected, autoCount, "automatic");
+
+    // The last instance has every weight a multiple of 1000, so GCD scaling makes it dense-sized
+    int hugeSizes[] = {30, 200, 1000};
+    int hugeCapacities[] = {1000000000, 1000000000, 100000000};
+    int hugeUnits[] = {1, 1, 1000};
+    for (int h = 0; h < 3; h++) {
+        int n = hugeSizes[h];
+        struct Item *hugeItems = malloc(n * sizeof(struct Item));
+        struct SelectedItem *hugeSelected = malloc(n * sizeof(struct SelectedItem));
+        int maxUnits = 2 * (hugeCapacities[h] / n / hugeUnits[h]) + 1;
+        for (int i = 0; i < n; i++) {
+            hugeItems[i].weight = hugeUnits[h] * (1 + rand() % maxUnits);
+            hugeItems[i].value = 1 + rand() % 100000;
+        }
+        clock_t start = clock();
+        int value = autoKnapsack(hugeItems, n, hugeCapacities[h], hugeSelected, &autoCount, &engine);
+        double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        long long weight = 0, check = 0;
+        for (int k = 0; k < autoCount; k++) {
+            weight += hugeSelected[k].weight;
+            check += hugeSelected[k].value;
+        }
+        printf("%d items, capacity %d: value %d with %s in %.3f s (selection %s)\n", n, hugeCapacities[h], value,
+               engineNames[engine], elapsed, (check == value && weight <= hugeCapacities[h]) ? "consistent" : "INCONSISTENT");
+        free(hugeItems);
+        free(hugeSelected);
+    }
+
+    // Cross-check the three engines on small random instances
+    int disagreements = 0;
+    for (int t = 0; t < 2000; t++) {
+        int n = 1 + rand() % 16, W = rand() % 200;
+        struct Item small[16];
+        struct SelectedItem sel[16];
+        int c;
+        for (int i = 0; i < n; i++) {
+            small[i].weight = 1 + rand() % 50;
+            small[i].value = rand() % 50;
+        }
+        int dense = dpKnapsackLinear(small, n, W, sel, &c);
+        disagreements += sparseKnapsack(small, n, W, sel, &c) != dense;
+        disagreements += meetInTheMiddleKnapsack(small, n, W, sel, &c) != dense;
+    }
+    printf("Engine cross-check on 2000 random instances: %d disagreements\n", disagreements);
+
+    // Cross-check the linear-memory selection against the full table on tie-heavy instances
+    // (small weights and values, so many selections reach the same optimum)
+    int selectionMismatches = 0;
+    for (int t = 0; t < 3000; t++) {
+        int n = 1 + rand() % 16, W = rand() % 40;
+        struct Item small[16];
+        struct SelectedItem full[16], linear[16];
+        int fullCount, linearCount;
+        for (int i = 0; i < n; i++) {
+            small[i].weight = 1 + rand() % 8;
+            small[i].value = rand() % 6;
+        }
+        int fullValue = dpKnapsack(small, n, W, full, &fullCount);
+        int linearValue = dpKnapsackLinear(small, n, W, linear, &linearCount);
+        int same = fullValue == linearValue && fullCount == linearCount;
+        for (int k = 0; same && k < fullCount; k++)
+            same = full[k].index == linear[k].index;
+        selectionMismatches += !same;
+    }
+    printf("Linear-memory DP vs full table on 3000 tie-heavy instances: %d selections differ\n\n", selectionMismatches);
+
+    // Large instance: a full table would need n * W ints, the row solver needs O(n + W log n)
+    int nLarge = 2000, WLarge = 1000000;
+    struct Item *large = malloc(nLarge * sizeof(struct Item));
+    struct SelectedItem *selectedLarge = malloc(nLarge * sizeof(struct SelectedItem));
+    for (int i = 0; i < nLarge; i++) {
+        large[i].weight = 1 + rand() % 10000;
+        large[i].value = large[i].weight + rand() % 1000;
+    }
+    int countLarge = 0;
+    clock_t start = clock();
+    int valueLarge = dpKnapsackLinear(large, nLarge, WLarge, selectedLarge, &countLarge);
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    long long weightLarge = 0, checkValue = 0;
+    for (int i = 0; i < countLarge; i++) {
+        weightLarge += selectedLarge[i].weight;
+        checkValue += selectedLarge[i].value;
+    }
+    printf("Large instance: %d items, capacity %d\n", nLarge, WLarge);
+    printf("Total Value Obtained: %d (%d items, weight %lld, selection %s), Time: %.3f s\n",
+           valueLarge, countLarge, weightLarge,
+           (checkValue == valueLarge && weightLarge <= WLarge) ? "consistent" : "INCONSISTENT", elapsed);
+    free(large);
+    free(selectedLarge);
+
     return 0;
 }
\ No newline at end of file
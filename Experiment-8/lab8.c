@@ -1,9 +1,219 @@
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
-#define MAX 100
+#define WRITER_BUFFER 65536        // Bytes collected before a solution batch is written out
+#define BITSET_MAX_SUM (1 << 25)   // Largest target the bitset engine accepts (about 136 MB of state)
+#define MITM_MAX_N 48              // Largest n for meet in the middle (2^24 sums per half)
+#define TASKS_PER_THREAD 32        // Subtrees carved per worker so stealing can even out the load
+#define MAX_SPLIT_DEPTH 20         // Deepest level at which the search tree is cut into tasks
+#define INDEX_MAX_SUM (1LL << 30)  // Largest total a bitset index covers without witnesses (128 MB)
+#define TABLE_INDEX_MAX_N 24       // Largest n for the sorted table of all subset sums
+
+// Modes of the iterative enumerator
+enum SubsetMode {
+    MODE_PRINT_ALL,  // Write every solution
+    MODE_COUNT,      // Only count solutions
+    MODE_FIRST_K     // Write solutions and stop after the first k
+};
+
+// Engines that decide whether some subset reaches the target and return one witness
+enum SubsetEngine {
+    ENGINE_AUTO,       // Let chooseSubsetEngine decide
+    ENGINE_BACKTRACK,  // Pruned DFS of enumerateSubsets, stopped at the first solution
+    ENGINE_BITSET,     // Word-parallel DP over reachable sums 0..target
+    ENGINE_MITM        // Sorted subset sums of both halves matched with two pointers
+};
+
+// Structure to collect output in memory and write it in large blocks.
+// With out == NULL nothing is printed and the last subset is kept in captured[] instead.
+typedef struct {
+    FILE *out;
+    char *buf;
+    size_t len;
+    int *captured;
+    int capturedSize;
+} BufferedWriter;
+
+// Frame of the explicit DFS stack: the subset buffer holds `size` elements on this path
+typedef struct {
+    int index;
+    long long total;
+    int size;
+} SubsetFrame;
+
+// Read-only description of one search over a sorted set and its suffix sums
+typedef struct {
+    const int *set;
+    const long long *suffix;
+    int n;
+    long long targetSum;
+    enum SubsetMode mode;
+    long long k;
+    atomic_llong *claimed;  // Solutions claimed across threads for MODE_FIRST_K (NULL: local count only)
+} SubsetSearch;
+
+// Subtree handed to a worker: the first `depth` sorted elements are fixed by mask
+typedef struct {
+    SubsetFrame root;
+    unsigned int mask;
+} SubsetTask;
+
+// Deque of task ids: the owner takes from the head, thieves take from the tail
+typedef struct {
+    int *ids;
+    int head, tail;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+// Structure shared by the enumeration workers
+typedef struct {
+    SubsetSearch search;
+    SubsetTask *tasks;
+    int taskCount;
+    TaskDeque *deques;
+    int threads;
+    int ordered;            // Keep each task's output apart and merge in sequential order
+    FILE *out;              // Destination for unordered output (NULL in MODE_COUNT)
+    char **taskOutput;      // Ordered mode: output of each task
+    size_t *taskOutputLen;
+    atomic_llong found;
+    atomic_llong nodes;
+} ParallelState;
+
+typedef struct {
+    ParallelState *state;
+    int id;
+} WorkerArg;
+
+// Kinds of reachable-sums index
+enum IndexKind {
+    INDEX_BITSET,  // One bit per sum 0..total, O(1) lookup
+    INDEX_TABLE    // Sorted distinct subset sums, binary search
+};
+
+// Index answering "does some subset sum to t?" for one fixed set and many targets
+typedef struct {
+    enum IndexKind kind;
+    int n;
+    int *set;              // Copy of the set, witnesses refer to its positions
+    long long total;
+    uint64_t *reach;       // Bitset: bit s set when s is reachable
+    int *firstItem;        // Bitset with witnesses: see reachableSums
+    long long *sums;       // Table: distinct reachable sums, ascending
+    unsigned int *masks;   // Table with witnesses: one subset per sum
+    long long count;       // Table: number of distinct sums
+    size_t bytes;          // Memory held by the index
+} SumIndex;
+
+// ==================== Instrumentation ====================
+// Build with -DSEARCH_STATS to count what the searches do. Without it every STAT_ macro expands to
+// nothing, so the default build runs exactly the uninstrumented code.
+#define STATS_DEPTHS 64  // Depth histogram buckets; deeper nodes land in the last one
+
+enum StatsPhase { PHASE_SETUP, PHASE_SEARCH, PHASE_FLUSH, PHASE_COUNT };
+
+#ifdef SEARCH_STATS
+typedef struct {
+    long long expanded;
+    long long prunedBound;       // Remaining elements cannot reach the target
+    long long prunedInfeasible;  // Sum overshoots or no elements are left
+    long long solutions;
+    long long peakStack;         // Largest explicit stack (iterative search)
+    long long depthHistogram[STATS_DEPTHS];
+    double phaseSeconds[PHASE_COUNT];
+} SearchStats;
+
+static _Thread_local SearchStats stats;  // Per thread, so parallel workers never share counters
+static SearchStats workerStats;          // Counters merged in by finished worker threads
+static pthread_mutex_t workerStatsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static double statsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void statsAdd(SearchStats *to, const SearchStats *from) {
+    to->expanded += from->expanded;
+    to->prunedBound += from->prunedBound;
+    to->prunedInfeasible += from->prunedInfeasible;
+    to->solutions += from->solutions;
+    if (from->peakStack > to->peakStack)
+        to->peakStack = from->peakStack;
+    for (int i = 0; i < STATS_DEPTHS; i++)
+        to->depthHistogram[i] += from->depthHistogram[i];
+    for (int i = 0; i < PHASE_COUNT; i++)
+        to->phaseSeconds[i] += from->phaseSeconds[i];
+}
+
+// Function to write the counters of this thread plus merged workers as one JSON line, then reset them
+static void statsReport(FILE *out, const char *solver) {
+    static const char *phaseNames[PHASE_COUNT] = {"setup", "search", "flush"};
+    SearchStats total = stats;
+    pthread_mutex_lock(&workerStatsLock);
+    statsAdd(&total, &workerStats);
+    memset(&workerStats, 0, sizeof(workerStats));
+    pthread_mutex_unlock(&workerStatsLock);
+    memset(&stats, 0, sizeof(stats));
+
+    int deepest = STATS_DEPTHS - 1;
+    while (deepest > 0 && total.depthHistogram[deepest] == 0)
+        deepest--;
+    fprintf(out, "{\"solver\":\"%s\",\"expanded\":%lld,\"pruned_bound\":%lld,\"pruned_infeasible\":%lld,"
+            "\"solutions\":%lld,\"peak_stack\":%lld,\"depth_histogram\":[", solver, total.expanded,
+            total.prunedBound, total.prunedInfeasible, total.solutions, total.peakStack);
+    for (int i = 0; i <= deepest; i++)
+        fprintf(out, i ? ",%lld" : "%lld", total.depthHistogram[i]);
+    fprintf(out, "],\"phase_seconds\":{");
+    for (int i = 0; i < PHASE_COUNT; i++)
+        fprintf(out, "%s\"%s\":%.6f", i ? "," : "", phaseNames[i], total.phaseSeconds[i]);
+    fprintf(out, "}}\n");
+}
+
+#define STAT_INC(field) (stats.field++)
+#define STAT_MAX(field, value) do { if ((value) > stats.field) stats.field = (value); } while (0)
+#define STAT_DEPTH(depth) (stats.depthHistogram[(depth) < STATS_DEPTHS ? (depth) : STATS_DEPTHS - 1]++)
+#define STAT_CUT(infeasible) do { if (infeasible) stats.prunedInfeasible++; else stats.prunedBound++; } while (0)
+#define STAT_PHASE_BEGIN(phase) double statsStart##phase = statsNow()
+#define STAT_PHASE_END(phase) (stats.phaseSeconds[phase] += statsNow() - statsStart##phase)
+#define STAT_MERGE_THREAD() do { pthread_mutex_lock(&workerStatsLock); statsAdd(&workerStats, &stats); \
+                                 pthread_mutex_unlock(&workerStatsLock); memset(&stats, 0, sizeof(stats)); } while (0)
+#define STAT_REPORT(solver) statsReport(stderr, solver)
+#else
+#define STAT_INC(field) ((void)0)
+#define STAT_MAX(field, value) ((void)0)
+#define STAT_DEPTH(depth) ((void)0)
+#define STAT_CUT(infeasible) ((void)0)
+#define STAT_PHASE_BEGIN(phase) ((void)0)
+#define STAT_PHASE_END(phase) ((void)0)
+#define STAT_MERGE_THREAD() ((void)0)
+#define STAT_REPORT(solver) ((void)0)
+#endif
+
+long long nodesVisited = 0;  // Nodes expanded by the recursive sumOfSubsets
 
 void printSubset(int subset[], int size);
 void sumOfSubsets(int set[], int subset[], int n, int subsetSize, int total, int nodeIndex, int targetSum, int* found);
+void writerInit(BufferedWriter *w, FILE *out);
+void writerFlush(BufferedWriter *w);
+void writeSubset(BufferedWriter *w, const int subset[], int size);
+long long enumerateSubsets(int set[], int n, long long targetSum, enum SubsetMode mode, long long k, BufferedWriter *w, long long *nodes);
+long long parallelEnumerateSubsets(int set[], int n, long long targetSum, enum SubsetMode mode, long long k,
+                                   int threads, int ordered, FILE *out, long long *nodes);
+int bitsetSubsetSum(const int set[], int n, long long targetSum, int take[]);
+int meetInTheMiddleSubsetSum(const int set[], int n, long long targetSum, int take[]);
+enum SubsetEngine chooseSubsetEngine(const int set[], int n, long long targetSum);
+int solveSubsetSum(const int set[], int n, long long targetSum, enum SubsetEngine engine, int take[]);
+int buildSumIndex(SumIndex *idx, const int set[], int n, int witnesses);
+int querySumIndex(const SumIndex *idx, long long target, int take[]);
+void freeSumIndex(SumIndex *idx);
 
 // Function to print a solution (a valid subset)
 void printSubset(int subset[], int size) {
@@ -16,8 +226,13 @@ void printSubset(int subset[], int size) {
 
 // Recursive function to find subsets with sum equal to targetSum
 void sumOfSubsets(int set[], int subset[], int n, int subsetSize, int total, int nodeIndex, int targetSum, int* found) {
+    nodesVisited++;
+    STAT_INC(expanded);
+    STAT_DEPTH(nodeIndex);
+
     // If the total is equal to targetSum, we found a solution
     if (total == targetSum) {
+        STAT_INC(solutions);
         printSubset(subset, subsetSize);
         *found = 1;  // Set found to true
         return;
@@ -25,6 +240,7 @@ void sumOfSubsets(int set[], int subset[], int n, int subsetSize, int total, int
 
     // If total exceeds targetSum or we've explored all elements, return
     if (total > targetSum || nodeIndex >= n) {
+        STAT_INC(prunedInfeasible);
         return;
     }
 
@@ -36,33 +252,1072 @@ void sumOfSubsets(int set[], int subset[], int n, int subsetSize, int total, int
     sumOfSubsets(set, subset, n, subsetSize, total, nodeIndex + 1, targetSum, found);
 }
 
-int main() {
-    int n, targetSum;
-    int set[MAX], subset[MAX];
-    int found = 0;  // Flag to indicate if a solution is found
+// ==================== Buffered Output ====================
+void writerInit(BufferedWriter *w, FILE *out) {
+    w->out = out;
+    w->buf = malloc(WRITER_BUFFER);
+    w->len = 0;
+    w->captured = NULL;
+    w->capturedSize = 0;
+}
+
+void writerFlush(BufferedWriter *w) {
+    if (w->out)
+        fwrite(w->buf, 1, w->len, w->out);
+    w->len = 0;
+}
+
+// Function to append "{ a b c }\n" (the printSubset format) to the writer
+void writeSubset(BufferedWriter *w, const int subset[], int size) {
+    if (!w->out) {
+        w->captured = realloc(w->captured, (size > 0 ? size : 1) * sizeof(int));
+        memcpy(w->captured, subset, size * sizeof(int));
+        w->capturedSize = size;
+        return;
+    }
+    // Each number takes at most 11 characters plus a space
+    if (w->len + 12 * (size_t)size + 8 > WRITER_BUFFER)
+        writerFlush(w);
+    if (12 * (size_t)size + 8 > WRITER_BUFFER) {
+        fprintf(w->out, "{ ");
+        for (int i = 0; i < size; i++)
+            fprintf(w->out, "%d ", subset[i]);
+        fprintf(w->out, "}\n");
+        return;
+    }
+    w->buf[w->len++] = '{';
+    w->buf[w->len++] = ' ';
+    for (int i = 0; i < size; i++)
+        w->len += sprintf(w->buf + w->len, "%d ", subset[i]);
+    w->buf[w->len++] = '}';
+    w->buf[w->len++] = '\n';
+}
+
+// ==================== Iterative Enumerator ====================
+static int compareInts(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to sort the set ascending (in place) and return its suffix sums, suffix[i] = set[i] + ... + set[n-1]
+static long long *prepareSearch(int set[], int n) {
+    qsort(set, n, sizeof(int), compareInts);
+    long long *suffix = malloc((n + 1) * sizeof(long long));
+    suffix[n] = 0;
+    for (int i = n - 1; i >= 0; i--)
+        suffix[i] = suffix[i + 1] + set[i];
+    return suffix;
+}
+
+// Function to search the subtree below root. subset[0..root.size-1] must already hold the elements
+// chosen on the way down, and stack needs room for n + 1 frames. A path is cut as soon as
+//   total + suffix[i] < targetSum  (even taking everything left cannot reach the target), or
+//   total + set[i] > targetSum     (the smallest remaining element already overshoots).
+// The include branch is followed directly and the exclude branch is pushed for later, so solutions
+// come out in the same include-first order as sumOfSubsets. Returns the solutions found here.
+static long long searchSubtree(const SubsetSearch *s, SubsetFrame root, int subset[], SubsetFrame stack[],
+                               BufferedWriter *w, long long *visited) {
+    const int *set = s->set;
+    const long long *suffix = s->suffix;
+    long long targetSum = s->targetSum;
+    int n = s->n, top = 0, stop = 0;
+    long long found = 0, nodes = 0;
+    stack[top++] = root;
+
+    while (top > 0 && !stop) {
+        SubsetFrame f = stack[--top];
+        for (;;) {
+            nodes++;
+            STAT_INC(expanded);
+            STAT_DEPTH(f.index);
+            if (f.total == targetSum) {
+                // A solution is only written if it is still among the first k (with a shared counter,
+                // across all threads)
+                if (s->mode == MODE_FIRST_K
+                    && (s->claimed ? atomic_fetch_add(s->claimed, 1) >= s->k : found >= s->k)) {
+                    stop = 1;
+                    break;
+                }
+                found++;
+                STAT_INC(solutions);
+                if (s->mode != MODE_COUNT)
+                    writeSubset(w, subset, f.size);
+                break;
+            }
+            if (f.index >= n || f.total + suffix[f.index] < targetSum || f.total + set[f.index] > targetSum) {
+                STAT_CUT(f.index >= n || f.total + set[f.index] > targetSum);
+                break;
+            }
+            // Exclude branch, only worth a frame if the rest can still reach the target
+            if (f.total + suffix[f.index + 1] >= targetSum) {
+                stack[top++] = (SubsetFrame){f.index + 1, f.total, f.size};
+                STAT_MAX(peakStack, top);
+            } else {
+                STAT_INC(prunedBound);
+            }
+            subset[f.size++] = set[f.index];
+            f.total += set[f.index++];
+        }
+        if (s->mode == MODE_FIRST_K && found >= s->k)
+            stop = 1;
+    }
+    *visited += nodes;
+    return found;
+}
+
+// Iterative sum-of-subsets over non-negative elements. The set is sorted ascending (in place) and
+// searched with the pruned explicit-stack DFS of searchSubtree.
+// Returns the number of solutions; nodes gets the nodes expanded.
+long long enumerateSubsets(int set[], int n, long long targetSum, enum SubsetMode mode, long long k, BufferedWriter *w, long long *nodes) {
+    STAT_PHASE_BEGIN(PHASE_SETUP);
+    long long *suffix = prepareSearch(set, n);
+    SubsetSearch search = {set, suffix, n, targetSum, mode, k, NULL};
+    int *subset = malloc((n > 0 ? n : 1) * sizeof(int));
+    SubsetFrame *stack = malloc((n + 1) * sizeof(SubsetFrame));
+    long long visited = 0;
+    STAT_PHASE_END(PHASE_SETUP);
+    STAT_PHASE_BEGIN(PHASE_SEARCH);
+    long long found = searchSubtree(&search, (SubsetFrame){0, 0, 0}, subset, stack, w, &visited);
+    STAT_PHASE_END(PHASE_SEARCH);
+
+    STAT_PHASE_BEGIN(PHASE_FLUSH);
+    if (w)
+        writerFlush(w);
+    STAT_PHASE_END(PHASE_FLUSH);
+    if (nodes)
+        *nodes = visited;
+    free(suffix);
+    free(subset);
+    free(stack);
+    return found;
+}
+
+// ==================== Parallel Enumerator ====================
+// Function to walk the top `depth` levels of the search tree in include-first order and record
+// every surviving node at that depth (or earlier solution) as a task, so task order is output order
+static void collectTasks(const SubsetSearch *s, int index, long long total, unsigned int mask, int size, int depth,
+                         SubsetTask **tasks, int *count, int *capacity, long long *visited) {
+    int leaf = total == s->targetSum || index == depth;
+    if (!leaf && (index >= s->n || total + s->suffix[index] < s->targetSum || total + s->set[index] > s->targetSum))
+        return;
+    if (leaf) {
+        if (*count == *capacity) {
+            *capacity *= 2;
+            *tasks = realloc(*tasks, *capacity * sizeof(SubsetTask));
+        }
+        (*tasks)[(*count)++] = (SubsetTask){{index, total, size}, mask};
+        return;
+    }
+    ++*visited;
+    STAT_INC(expanded);
+    STAT_DEPTH(index);
+    collectTasks(s, index + 1, total + s->set[index], mask | 1u << index, size + 1, depth, tasks, count, capacity, visited);
+    if (total + s->suffix[index + 1] >= s->targetSum)
+        collectTasks(s, index + 1, total, mask, size, depth, tasks, count, capacity, visited);
+}
+
+// Function to take the next task: own deque from the head first, then steal from the tail of the others
+static int nextTask(ParallelState *state, int id) {
+    for (int d = 0; d < state->threads; d++) {
+        TaskDeque *q = &state->deques[(id + d) % state->threads];
+        int task = -1;
+        pthread_mutex_lock(&q->lock);
+        if (q->head < q->tail)
+            task = (d == 0) ? q->ids[q->head++] : q->ids[--q->tail];
+        pthread_mutex_unlock(&q->lock);
+        if (task >= 0)
+            return task;
+    }
+    return -1;
+}
+
+// Worker thread: run tasks with a private subset buffer, stack and output buffer.
+// Unordered output goes straight to the shared stream in whole blocks (fwrite locks the stream).
+static void *enumerationWorker(void *arg) {
+    ParallelState *state = ((WorkerArg *)arg)->state;
+    int id = ((WorkerArg *)arg)->id;
+    const SubsetSearch *s = &state->search;
+    int *subset = malloc((s->n > 0 ? s->n : 1) * sizeof(int));
+    SubsetFrame *stack = malloc((s->n + 1) * sizeof(SubsetFrame));
+    BufferedWriter w;
+    writerInit(&w, state->out);
+    long long nodes = 0, found = 0;
+    int task;
+
+    while ((task = nextTask(state, id)) >= 0) {
+        if (s->claimed && atomic_load(s->claimed) >= s->k)
+            break;
+        SubsetTask *t = &state->tasks[task];
+        for (int i = 0, size = 0; size < t->root.size; i++)
+            if (t->mask >> i & 1)
+                subset[size++] = s->set[i];
+
+        if (state->ordered && s->mode != MODE_COUNT)
+            w.out = open_memstream(&state->taskOutput[task], &state->taskOutputLen[task]);
+        STAT_PHASE_BEGIN(PHASE_SEARCH);
+        found += searchSubtree(s, t->root, subset, stack, &w, &nodes);
+        STAT_PHASE_END(PHASE_SEARCH);
+        STAT_PHASE_BEGIN(PHASE_FLUSH);
+        writerFlush(&w);
+        if (state->ordered && s->mode != MODE_COUNT)
+            fclose(w.out);
+        STAT_PHASE_END(PHASE_FLUSH);
+    }
+    if (id != 0)
+        STAT_MERGE_THREAD();
+
+    atomic_fetch_add(&state->found, found);
+    atomic_fetch_add(&state->nodes, nodes);
+    free(w.buf);
+    free(subset);
+    free(stack);
+    return NULL;
+}
+
+// Function to enumerate subsets on a pool of threads. The tree is cut at a depth that gives about
+// TASKS_PER_THREAD subtrees per thread; each deque starts with a contiguous block of them and idle
+// workers steal. With ordered set the output of every task is kept in memory and written in task
+// order, which reproduces the sequential output exactly; otherwise blocks appear as they fill.
+// In MODE_FIRST_K the unordered run writes exactly k solutions, chosen by whichever threads claim
+// them first; the ordered run writes the sequential first k.
+long long parallelEnumerateSubsets(int set[], int n, long long targetSum, enum SubsetMode mode, long long k,
+                                   int threads, int ordered, FILE *out, long long *nodes) {
+    if (threads < 1)
+        threads = 1;
+    long long *suffix = prepareSearch(set, n);
+    atomic_llong claimed;
+    atomic_init(&claimed, 0);
+    ParallelState state;
+    state.search = (SubsetSearch){set, suffix, n, targetSum, mode, k, NULL};
+    if (mode == MODE_FIRST_K && !ordered)
+        state.search.claimed = &claimed;
+
+    int depth = 0;
+    while ((1LL << depth) < (long long)threads * TASKS_PER_THREAD && depth < n && depth < MAX_SPLIT_DEPTH)
+        depth++;
+    int capacity = 64;
+    state.tasks = malloc(capacity * sizeof(SubsetTask));
+    state.taskCount = 0;
+    long long splitNodes = 0;
+    collectTasks(&state.search, 0, 0, 0, 0, depth, &state.tasks, &state.taskCount, &capacity, &splitNodes);
+
+    state.threads = threads;
+    state.ordered = ordered;
+    state.out = (mode == MODE_COUNT) ? NULL : out;
+    state.taskOutput = calloc(state.taskCount + 1, sizeof(char *));
+    state.taskOutputLen = calloc(state.taskCount + 1, sizeof(size_t));
+    atomic_init(&state.found, 0);
+    atomic_init(&state.nodes, splitNodes);
+    state.deques = malloc(threads * sizeof(TaskDeque));
+    for (int t = 0; t < threads; t++) {
+        TaskDeque *q = &state.deques[t];
+        int from = (int)((long long)state.taskCount * t / threads);
+        int to = (int)((long long)state.taskCount * (t + 1) / threads);
+        q->ids = malloc((to - from + 1) * sizeof(int));
+        q->head = 0;
+        q->tail = to - from;
+        for (int i = from; i < to; i++)
+            q->ids[i - from] = i;
+        pthread_mutex_init(&q->lock, NULL);
+    }
+
+    pthread_t tids[threads];
+    WorkerArg args[threads];
+    for (int t = 0; t < threads; t++)
+        args[t] = (WorkerArg){&state, t};
+    for (int t = 1; t < threads; t++)
+        pthread_create(&tids[t], NULL, enumerationWorker, &args[t]);
+    enumerationWorker(&args[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(tids[t], NULL);
+
+    long long found = atomic_load(&state.found);
+    if (ordered && mode != MODE_COUNT) {
+        // Every task stopped after its own first k, so the sequential first k are all in memory
+        long long written = 0;
+        for (int i = 0; i < state.taskCount; i++) {
+            char *text = state.taskOutput[i];
+            size_t len = state.taskOutputLen[i];
+            if (mode == MODE_FIRST_K) {
+                size_t cut = 0;
+                while (cut < len && written < k)
+                    if (text[cut++] == '\n')
+                        written++;
+                len = cut;
+            }
+            if (text)
+                fwrite(text, 1, len, out);
+            free(text);
+        }
+        if (mode == MODE_FIRST_K && found > k)
+            found = k;
+    }
+
+    if (nodes)
+        *nodes = atomic_load(&state.nodes);
+    for (int t = 0; t < threads; t++) {
+        pthread_mutex_destroy(&state.deques[t].lock);
+        free(state.deques[t].ids);
+    }
+    free(state.deques);
+    free(state.taskOutput);
+    free(state.taskOutputLen);
+    free(state.tasks);
+    free(suffix);
+    return found;
+}
+
+// ==================== Decision Engines ====================
+// All engines assume non-negative elements. take[i] is set to 1 for the elements of the witness
+// (indices into the caller's set, which is left untouched) and 0 otherwise.
+
+// Function to run the bitset DP over sums 0..limit: bit s of `reach` (limit / 64 + 1 zeroed words on
+// entry) ends up set when some subset sums to s. Item i is added with a word-wise shift-or, walking
+// words from high to low so the update can happen in place, and only the words up to the sum of the
+// items seen so far are touched. If firstItem is given, bits that turn on for item i record
+// firstItem[s] = i; since s - set[i] was already reachable before item i, following firstItem from
+// any reachable sum back to 0 gives a witness. With stopAtLimit the DP ends once limit is reachable.
+static void reachableSums(const int set[], int n, int limit, int stopAtLimit, uint64_t *reach, int *firstItem) {
+    int words = limit / 64 + 1;
+    uint64_t lastMask = (limit % 64 == 63) ? ~0ULL : ((1ULL << (limit % 64 + 1)) - 1);
+    reach[0] = 1;
+    long long prefix = 0;
+
+    for (int i = 0; i < n && !(stopAtLimit && (reach[limit / 64] >> (limit % 64) & 1)); i++) {
+        int w = set[i];
+        if (w <= 0 || w > limit)
+            continue;
+        prefix += w;
+        int top = (int)((prefix < limit ? prefix : limit) / 64);
+        int wordShift = w / 64, bitShift = w % 64;
+
+        for (int j = top; j >= wordShift; j--) {
+            uint64_t shifted = reach[j - wordShift] << bitShift;
+            if (bitShift && j - wordShift > 0)
+                shifted |= reach[j - wordShift - 1] >> (64 - bitShift);
+            if (j == words - 1)
+                shifted &= lastMask;
+            uint64_t fresh = shifted & ~reach[j];
+            reach[j] |= fresh;
+            if (!firstItem)
+                continue;
+            while (fresh) {
+                firstItem[j * 64 + __builtin_ctzll(fresh)] = i;
+                fresh &= fresh - 1;
+            }
+        }
+    }
+}
+
+// Bitset DP for one target: reachableSums over 0..targetSum, stopped as soon as the target is hit
+int bitsetSubsetSum(const int set[], int n, long long targetSum, int take[]) {
+    memset(take, 0, n * sizeof(int));
+    if (targetSum < 0 || targetSum > BITSET_MAX_SUM)
+        return 0;
+    if (targetSum == 0)
+        return 1;
+
+    int T = (int)targetSum;
+    uint64_t *reach = calloc(T / 64 + 1, sizeof(uint64_t));
+    int *firstItem = malloc((T + 1) * sizeof(int));
+    reachableSums(set, n, T, 1, reach, firstItem);
+
+    int found = reach[T / 64] >> (T % 64) & 1;
+    if (found) {
+        for (int s = T; s > 0; s -= set[firstItem[s]])
+            take[firstItem[s]] = 1;
+    }
+    free(reach);
+    free(firstItem);
+    return found;
+}
+
+// Function to write the 2^h subset sums of a[0..h-1] to out in ascending order. Adding element x
+// merges the sorted list L with L + x, so no sort is needed. tmp must hold 2^h values as well.
+// If outMask is given (with tmpMask of the same size) it receives the subset behind each sum.
+static void sortedSubsetSums(const int a[], int h, long long *out, long long *tmp, unsigned int *outMask, unsigned int *tmpMask) {
+    long long len = 1;
+    out[0] = 0;
+    if (outMask)
+        outMask[0] = 0;
+    for (int e = 0; e < h; e++) {
+        long long i = 0, j = 0, m = 0;
+        while (i < len || j < len) {
+            int fromLeft = j >= len || (i < len && out[i] <= out[j] + a[e]);
+            if (fromLeft) {
+                if (outMask)
+                    tmpMask[m] = outMask[i];
+                tmp[m++] = out[i++];
+            } else {
+                if (outMask)
+                    tmpMask[m] = outMask[j] | 1u << e;
+                tmp[m++] = out[j++] + a[e];
+            }
+        }
+        memcpy(out, tmp, m * sizeof(long long));
+        if (outMask)
+            memcpy(outMask, tmpMask, m * sizeof(unsigned int));
+        len = m;
+    }
+}
+
+// Function to find which elements of a[0..h-1] add up to `sum`, walking the subsets in Gray-code
+// order so every step adds or removes one element. Marks them in take[].
+static void markHalfSubset(const int a[], int h, long long sum, int take[]) {
+    long long total = 0;
+    long long count = 1LL << h;
+    unsigned long long mask = 0;
+    for (long long g = 1; g < count && total != sum; g++) {
+        int bit = __builtin_ctzll(g);
+        mask ^= 1ULL << bit;
+        total += (mask >> bit & 1) ? a[bit] : -(long long)a[bit];
+    }
+    for (int i = 0; i < h; i++)
+        take[i] = (mask >> i) & 1;
+}
+
+// Meet in the middle: the sorted subset sums of the lower and upper halves are matched with one
+// pointer moving up the left list and one moving down the right list, O(2^(n/2)) time and memory.
+// Element values may be as large as an int; sums are kept in 64 bits.
+int meetInTheMiddleSubsetSum(const int set[], int n, long long targetSum, int take[]) {
+    memset(take, 0, n * sizeof(int));
+    if (n > MITM_MAX_N || targetSum < 0)
+        return 0;
+
+    int h1 = n / 2, h2 = n - h1;
+    long long len1 = 1LL << h1, len2 = 1LL << h2;
+    long long *left = malloc(len1 * sizeof(long long));
+    long long *right = malloc(len2 * sizeof(long long));
+    long long *tmp = malloc(len2 * sizeof(long long));
+    sortedSubsetSums(set, h1, left, tmp, NULL, NULL);
+    sortedSubsetSums(set + h1, h2, right, tmp, NULL, NULL);
+
+    long long i = 0, j = len2 - 1;
+    int found = 0;
+    while (i < len1 && j >= 0) {
+        long long s = left[i] + right[j];
+        if (s == targetSum) {
+            found = 1;
+            break;
+        }
+        if (s < targetSum)
+            i++;
+        else
+            j--;
+    }
+
+    if (found) {
+        markHalfSubset(set, h1, left[i], take);
+        markHalfSubset(set + h1, h2, right[j], take + h1);
+    }
+    free(left);
+    free(right);
+    free(tmp);
+    return found;
+}
+
+// Function to pick the cheaper decision engine: the bitset DP costs about n * target / 64 word
+// operations, meet in the middle about 2^(n/2) merge steps per half. When neither fits in memory
+// the pruned backtracker is the only option left.
+enum SubsetEngine chooseSubsetEngine(const int set[], int n, long long targetSum) {
+    (void)set;
+    double bitsetCost = (targetSum >= 0 && targetSum <= BITSET_MAX_SUM) ? (double)n * (targetSum / 64 + 1) : -1;
+    double mitmCost = (n <= MITM_MAX_N) ? 4.0 * (double)(1LL << ((n + 1) / 2)) : -1;
+
+    if (bitsetCost < 0 && mitmCost < 0)
+        return ENGINE_BACKTRACK;
+    if (bitsetCost < 0)
+        return ENGINE_MITM;
+    if (mitmCost < 0)
+        return ENGINE_BITSET;
+    return (bitsetCost <= mitmCost) ? ENGINE_BITSET : ENGINE_MITM;
+}
+
+// Function to decide whether some subset of set sums to targetSum and fill take[] with a witness
+int solveSubsetSum(const int set[], int n, long long targetSum, enum SubsetEngine engine, int take[]) {
+    if (engine == ENGINE_AUTO)
+        engine = chooseSubsetEngine(set, n, targetSum);
+    if (engine == ENGINE_BITSET)
+        return bitsetSubsetSum(set, n, targetSum, take);
+    if (engine == ENGINE_MITM)
+        return meetInTheMiddleSubsetSum(set, n, targetSum, take);
+
+    // Backtracker: run the enumerator on a copy, capture its first solution and map values back
+    int *copy = malloc((n > 0 ? n : 1) * sizeof(int));
+    memcpy(copy, set, n * sizeof(int));
+    BufferedWriter w;
+    writerInit(&w, NULL);
+    int found = enumerateSubsets(copy, n, targetSum, MODE_FIRST_K, 1, &w, NULL) > 0;
+
+    memset(take, 0, n * sizeof(int));
+    for (int c = 0; found && c < w.capturedSize; c++) {
+        for (int i = 0; i < n; i++) {
+            if (!take[i] && set[i] == w.captured[c]) {
+                take[i] = 1;
+                break;
+            }
+        }
+    }
+    free(w.captured);
+    free(w.buf);
+    free(copy);
+    return found;
+}
+
+// ==================== Reachable-Sums Index ====================
+// Function to build an index over every subset sum of set. Small totals get a bitset from
+// reachableSums (plus firstItem when witnesses are wanted, which limits the total to BITSET_MAX_SUM);
+// otherwise, for n up to TABLE_INDEX_MAX_N, all 2^n sums are merged into a sorted table and
+// deduplicated, keeping one mask per sum. Returns 0 when neither fits.
+int buildSumIndex(SumIndex *idx, const int set[], int n, int witnesses) {
+    memset(idx, 0, sizeof(*idx));
+    idx->n = n;
+    for (int i = 0; i < n; i++)
+        idx->total += set[i] > 0 ? set[i] : 0;
+    idx->set = malloc((n > 0 ? n : 1) * sizeof(int));
+    memcpy(idx->set, set, n * sizeof(int));
+
+    if (idx->total <= (witnesses ? BITSET_MAX_SUM : INDEX_MAX_SUM)) {
+        int limit = (int)idx->total;
+        idx->kind = INDEX_BITSET;
+        idx->reach = calloc(limit / 64 + 1, sizeof(uint64_t));
+        idx->bytes = (limit / 64 + 1) * sizeof(uint64_t);
+        if (witnesses) {
+            idx->firstItem = malloc((limit + 1) * sizeof(int));
+            idx->bytes += (limit + 1) * sizeof(int);
+        }
+        reachableSums(set, n, limit, 0, idx->reach, idx->firstItem);
+        return 1;
+    }
+    if (n > TABLE_INDEX_MAX_N) {
+        free(idx->set);
+        idx->set = NULL;
+        return 0;
+    }
+
+    long long len = 1LL << n;
+    long long *tmp = malloc(len * sizeof(long long));
+    unsigned int *tmpMask = witnesses ? malloc(len * sizeof(unsigned int)) : NULL;
+    idx->kind = INDEX_TABLE;
+    idx->sums = malloc(len * sizeof(long long));
+    idx->masks = witnesses ? malloc(len * sizeof(unsigned int)) : NULL;
+    sortedSubsetSums(set, n, idx->sums, tmp, idx->masks, tmpMask);
+
+    long long m = 0;
+    for (long long i = 0; i < len; i++) {
+        if (m > 0 && idx->sums[m - 1] == idx->sums[i])
+            continue;
+        idx->sums[m] = idx->sums[i];
+        if (witnesses)
+            idx->masks[m] = idx->masks[i];
+        m++;
+    }
+    idx->count = m;
+    idx->sums = realloc(idx->sums, m * sizeof(long long));
+    if (witnesses)
+        idx->masks = realloc(idx->masks, m * sizeof(unsigned int));
+    idx->bytes = m * (sizeof(long long) + (witnesses ? sizeof(unsigned int) : 0));
+    free(tmp);
+    free(tmpMask);
+    return 1;
+}
+
+// Function to answer one target. If take is given (and the index was built with witnesses) it
+// receives the positions of a subset reaching the target.
+int querySumIndex(const SumIndex *idx, long long target, int take[]) {
+    if (target < 0 || target > idx->total)
+        return 0;
+
+    if (idx->kind == INDEX_BITSET) {
+        if (!(idx->reach[target / 64] >> (target % 64) & 1))
+            return 0;
+        if (take && idx->firstItem) {
+            memset(take, 0, idx->n * sizeof(int));
+            for (long long s = target; s > 0; s -= idx->set[idx->firstItem[s]])
+                take[idx->firstItem[s]] = 1;
+        }
+        return 1;
+    }
+
+    long long lo = 0, hi = idx->count - 1;
+    while (lo <= hi) {
+        long long mid = lo + (hi - lo) / 2;
+        if (idx->sums[mid] == target) {
+            if (take && idx->masks)
+                for (int i = 0; i < idx->n; i++)
+                    take[i] = idx->masks[mid] >> i & 1;
+            return 1;
+        }
+        if (idx->sums[mid] < target)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return 0;
+}
+
+void freeSumIndex(SumIndex *idx) {
+    free(idx->set);
+    free(idx->reach);
+    free(idx->firstItem);
+    free(idx->sums);
+    free(idx->masks);
+    memset(idx, 0, sizeof(*idx));
+}
+
+// ==================== Benchmark ====================
+static double wallTimeSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Function to compare nodes visited per second of the recursive and iterative enumerators.
+// Solutions are written to /dev/null so the numbers measure the search, not the terminal.
+void benchmarkSubsets() {
+    int sizes[] = {20, 24, 28};
+    FILE *devnull = fopen("/dev/null", "w");
+    srand(12345);
+
+    printf("n\tSolutions\tRecursive nodes\tNodes/s\t\tTime (s)\tIterative nodes\tNodes/s\t\tTime (s)\tCount-only (s)\n");
+    for (int s = 0; s < 3; s++) {
+        int n = sizes[s];
+        int *set = malloc(n * sizeof(int));
+        int *subset = malloc(n * sizeof(int));
+        long long sum = 0;
+        for (int i = 0; i < n; i++) {
+            set[i] = 1 + rand() % 1000;
+            sum += set[i];
+        }
+        int target = (int)(sum / 2);
+
+        // Recursive version prints with printf: point stdout at /dev/null while it runs
+        int found = 0;
+        fflush(stdout);
+        int savedStdout = dup(fileno(stdout));
+        dup2(fileno(devnull), fileno(stdout));
+        nodesVisited = 0;
+        double start = wallTimeSeconds();
+        sumOfSubsets(set, subset, n, 0, 0, 0, target, &found);
+        fflush(stdout);
+        double recursiveTime = wallTimeSeconds() - start;
+        dup2(savedStdout, fileno(stdout));
+        close(savedStdout);
+        long long recursiveNodes = nodesVisited;
+        STAT_REPORT("sumOfSubsets");
+
+        BufferedWriter w;
+        writerInit(&w, devnull);
+        long long nodes;
+        start = wallTimeSeconds();
+        long long solutions = enumerateSubsets(set, n, target, MODE_PRINT_ALL, 0, &w, &nodes);
+        double iterativeTime = wallTimeSeconds() - start;
+        free(w.buf);
+        STAT_REPORT("enumerateSubsets");
+
+        start = wallTimeSeconds();
+        enumerateSubsets(set, n, target, MODE_COUNT, 0, NULL, NULL);
+        double countTime = wallTimeSeconds() - start;
+        STAT_REPORT("enumerateSubsets count");
+
+        printf("%d\t%lld\t\t%lld\t%.3g\t\t%.4f\t\t%lld\t%.3g\t\t%.4f\t\t%.4f\n", n, solutions,
+               recursiveNodes, recursiveNodes / recursiveTime, recursiveTime,
+               nodes, nodes / iterativeTime, iterativeTime, countTime);
+        free(set);
+        free(subset);
+    }
+    fclose(devnull);
+}
+
+static const char *engineName(enum SubsetEngine engine) {
+    switch (engine) {
+    case ENGINE_BITSET: return "bitset DP";
+    case ENGINE_MITM: return "meet in the middle";
+    case ENGINE_BACKTRACK: return "backtracking";
+    default: return "auto";
+    }
+}
+
+// Function to time each applicable decision engine on instances of different shapes: small values
+// favour the bitset, few huge values favour meet in the middle. "-" marks an engine that was skipped.
+void benchmarkEngines() {
+    struct { int n; int maxValue; int backtrack; } cases[] = {
+        {26, 1000000000, 1}, {44, 1000000000, 0}, {200, 1000, 1}, {2000, 10000, 0}
+    };
+    enum SubsetEngine engines[] = {ENGINE_BACKTRACK, ENGINE_BITSET, ENGINE_MITM};
+    srand(777);
+
+    printf("\nn\tMax value\tFound\tBacktrack (s)\tBitset (s)\tMITM (s)\tAuto picks\n");
+    for (int c = 0; c < 4; c++) {
+        int n = cases[c].n;
+        int *set = malloc(n * sizeof(int));
+        int *take = malloc(n * sizeof(int));
+        long long sum = 0;
+        for (int i = 0; i < n; i++) {
+            set[i] = 1 + (int)(((long long)rand() * RAND_MAX + rand()) % cases[c].maxValue);
+            sum += set[i];
+        }
+        long long target = sum / 2 + 1;
+
+        int found = -1;
+        printf("%d\t%d\t", n, cases[c].maxValue);
+        char times[3][32];
+        for (int e = 0; e < 3; e++) {
+            int applicable = (engines[e] == ENGINE_BACKTRACK && cases[c].backtrack) ||
+                             (engines[e] == ENGINE_BITSET && target <= BITSET_MAX_SUM) ||
+                             (engines[e] == ENGINE_MITM && n <= MITM_MAX_N);
+            if (!applicable) {
+                strcpy(times[e], "-");
+                continue;
+            }
+            double start = wallTimeSeconds();
+            int ok = solveSubsetSum(set, n, target, engines[e], take);
+            snprintf(times[e], sizeof(times[e]), "%.4f", wallTimeSeconds() - start);
+
+            long long check = 0;
+            for (int i = 0; i < n; i++)
+                check += take[i] ? set[i] : 0;
+            if (ok && check != target)
+                printf("(bad witness from %s) ", engineName(engines[e]));
+            if (found >= 0 && ok != found)
+                printf("(engines disagree) ");
+            found = ok;
+        }
+        printf("%s\t%s\t\t%s\t\t%s\t\t%s\n", found ? "yes" : "no", times[0], times[1], times[2],
+               engineName(chooseSubsetEngine(set, n, target)));
+        free(set);
+        free(take);
+    }
+}
+
+// Function to measure the parallel enumerator on a set with millions of solutions: small values
+// around a target of half the total. Output goes to /dev/null; speedups are relative to the
+// sequential enumerator in the same mode, and every run must agree on the count.
+void benchmarkParallel() {
+    int n = 28;
+    int *set = malloc(n * sizeof(int));
+    long long sum = 0;
+    int maxThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    FILE *devnull = fopen("/dev/null", "w");
+    srand(4242);
+    for (int i = 0; i < n; i++) {
+        set[i] = 1 + rand() % 40;
+        sum += set[i];
+    }
+    long long target = sum / 2;
+
+    BufferedWriter w;
+    writerInit(&w, devnull);
+    long long nodes;
+    double start = wallTimeSeconds();
+    long long expected = enumerateSubsets(set, n, target, MODE_COUNT, 0, NULL, &nodes);
+    double sequential[2];
+    sequential[0] = wallTimeSeconds() - start;
+    start = wallTimeSeconds();
+    enumerateSubsets(set, n, target, MODE_PRINT_ALL, 0, &w, NULL);
+    sequential[1] = wallTimeSeconds() - start;
+    free(w.buf);
+
+    printf("\nParallel enumeration: n = %d, %lld solutions, %lld nodes, %d CPUs online\n", n, expected, nodes, maxThreads);
+    printf("Threads\tMode\t\tTime (s)\tSpeedup\n");
+    printf("seq\tcount\t\t%.4f\t\t1.00\n", sequential[0]);
+    printf("seq\tprint\t\t%.4f\t\t1.00\n", sequential[1]);
+    int counts[] = {1, 2, 4, 8};
+    const char *modes[] = {"count", "print", "print ordered"};
+    for (int c = 0; c < 4; c++) {
+        for (int m = 0; m < 3; m++) {
+            start = wallTimeSeconds();
+            long long found = parallelEnumerateSubsets(set, n, target, m == 0 ? MODE_COUNT : MODE_PRINT_ALL, 0,
+                                                       counts[c], m == 2, devnull, NULL);
+            double elapsed = wallTimeSeconds() - start;
+            printf("%d\t%-13s\t%.4f\t\t%.2f%s\n", counts[c], modes[m], elapsed, sequential[m > 0] / elapsed,
+                   found == expected ? "" : "  (count mismatch)");
+        }
+    }
+    fclose(devnull);
+    free(set);
+}
+
+// Function to measure index build time, memory and lookups per second for both index kinds.
+// Half of the targets are sums of random subsets, so the witness path is exercised as well.
+void benchmarkIndex() {
+    struct { int n; int maxValue; } cases[] = {{1000, 1000}, {22, 1000000000}};
+    long long queryCount = 1000000;
+    long long *queries = malloc(queryCount * sizeof(long long));
+    srand(99);
+
+    printf("\nIndex\t\tn\tWitnesses\tBuild (s)\tMemory (MB)\tQueries/s\tReachable\n");
+    for (int c = 0; c < 2; c++) {
+        int n = cases[c].n;
+        int *set = malloc(n * sizeof(int));
+        int *take = malloc(n * sizeof(int));
+        long long total = 0;
+        for (int i = 0; i < n; i++) {
+            set[i] = 1 + (int)(((long long)rand() * RAND_MAX + rand()) % cases[c].maxValue);
+            total += set[i];
+        }
+        for (long long q = 0; q < queryCount; q++) {
+            long long t = 0;
+            if (q % 2 == 0) {
+                for (int i = 0; i < n; i++)
+                    t += (rand() & 1) ? set[i] : 0;
+            } else {
+                t = ((long long)rand() * RAND_MAX + rand()) % (total + 1);
+            }
+            queries[q] = t;
+        }
+
+        for (int witnesses = 0; witnesses <= 1; witnesses++) {
+            SumIndex idx;
+            double start = wallTimeSeconds();
+            buildSumIndex(&idx, set, n, witnesses);
+            double buildTime = wallTimeSeconds() - start;
+
+            long long yes = 0;
+            start = wallTimeSeconds();
+            for (long long q = 0; q < queryCount; q++)
+                yes += querySumIndex(&idx, queries[q], witnesses ? take : NULL);
+            double queryTime = wallTimeSeconds() - start;
+
+            printf("%-12s\t%d\t%s\t\t%.4f\t\t%.1f\t\t%.3g\t\t%lld\n", idx.kind == INDEX_BITSET ? "bitset" : "sorted table",
+                   n, witnesses ? "yes" : "no", buildTime, idx.bytes / 1048576.0, queryCount / queryTime, yes);
+            freeSumIndex(&idx);
+        }
+        free(set);
+        free(take);
+    }
+    free(queries);
+}
+
+// Function to read every whitespace-separated integer of a file. Returns the count, or -1 (and
+// *values = NULL) if unreadable.
+static long long readNumbers(const char *path, long long **values) {
+    *values = NULL;
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *text = malloc(size + 1);
+    size_t got = fread(text, 1, size, f);
+    text[got] = '\0';
+    fclose(f);
+
+    long long count = 0, capacity = 1024;
+    *values = malloc(capacity * sizeof(long long));
+    char *p = text, *end;
+    for (;;) {
+        long long v = strtoll(p, &end, 10);
+        if (end == p)
+            break;
+        if (count == capacity) {
+            capacity *= 2;
+            *values = realloc(*values, capacity * sizeof(long long));
+        }
+        (*values)[count++] = v;
+        p = end;
+    }
+    free(text);
+    return count;
+}
+
+// Function to answer a file of targets against one set without prompts. The set file holds n and
+// the elements (the interactive input without the target). One line per query goes to stdout:
+// "<target> yes { a b }" (the subset only with witnesses) or "<target> no". Build time, index memory
+// and query throughput go to stderr so the answers can be piped on.
+int runIndexBatch(const char *setFile, const char *queryFile, int witnesses) {
+    long long *setValues, *queries;
+    long long setCount = readNumbers(setFile, &setValues);
+    long long queryCount = readNumbers(queryFile, &queries);
+    if (setCount < 1 || setValues[0] < 0 || setValues[0] > setCount - 1 || queryCount < 0) {
+        fprintf(stderr, "Could not read %s or %s\n", setFile, queryFile);
+        free(setValues);
+        free(queries);
+        return 1;
+    }
+    int n = (int)setValues[0];
+    for (int i = 0; i < n; i++) {
+        if (setValues[i + 1] < 0 || setValues[i + 1] > INT_MAX) {
+            fprintf(stderr, "%s: element %lld is not a non-negative int\n", setFile, setValues[i + 1]);
+            free(setValues);
+            free(queries);
+            return 1;
+        }
+    }
+    int *set = malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int i = 0; i < n; i++)
+        set[i] = (int)setValues[i + 1];
+    free(setValues);
+
+    SumIndex idx;
+    double start = wallTimeSeconds();
+    if (!buildSumIndex(&idx, set, n, witnesses)) {
+        fprintf(stderr, "Set too large to index: total %lld with n = %d\n", idx.total, n);
+        free(set);
+        free(queries);
+        return 1;
+    }
+    double buildTime = wallTimeSeconds() - start;
+
+    // Answer first (timed), then format the output
+    char *answer = malloc(queryCount + 1);
+    start = wallTimeSeconds();
+    for (long long q = 0; q < queryCount; q++)
+        answer[q] = (char)querySumIndex(&idx, queries[q], NULL);
+    double queryTime = wallTimeSeconds() - start;
+
+    int *take = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *subset = malloc((n > 0 ? n : 1) * sizeof(int));
+    BufferedWriter w;
+    writerInit(&w, stdout);
+    long long yes = 0;
+    start = wallTimeSeconds();
+    for (long long q = 0; q < queryCount; q++) {
+        if (w.len + 32 > WRITER_BUFFER)
+            writerFlush(&w);
+        if (!answer[q]) {
+            w.len += sprintf(w.buf + w.len, "%lld no\n", queries[q]);
+            continue;
+        }
+        w.len += sprintf(w.buf + w.len, witnesses ? "%lld yes " : "%lld yes\n", queries[q]);
+        yes++;
+        if (witnesses) {
+            int size = 0;
+            querySumIndex(&idx, queries[q], take);
+            for (int i = 0; i < n; i++)
+                if (take[i])
+                    subset[size++] = set[i];
+            writeSubset(&w, subset, size);
+        }
+    }
+    writerFlush(&w);
+    fflush(stdout);
+    double outputTime = wallTimeSeconds() - start;
+
+    fprintf(stderr, "Index: %s over n = %d, total %lld, built in %.4f s, %.1f MB\n",
+            idx.kind == INDEX_BITSET ? "bitset" : "sorted table", n, idx.total, buildTime, idx.bytes / 1048576.0);
+    fprintf(stderr, "Queries: %lld (%lld reachable), %.3g queries/s, output%s %.4f s\n", queryCount, yes,
+            queryTime > 0 ? queryCount / queryTime : 0.0, witnesses ? " with witnesses" : "", outputTime);
+
+    free(w.buf);
+    free(answer);
+    free(take);
+    free(subset);
+    free(queries);
+    free(set);
+    freeSumIndex(&idx);
+    return 0;
+}
+
+// Usage: lab8 [count | first K | solve | bench] [threads T] [ordered]
+//        lab8 index SETFILE QUERYFILE [witness]
+// Without arguments every solution is printed; solve only decides whether a subset exists and prints
+// one, using the engine the dispatcher picks. threads T enumerates on T threads, ordered keeps the
+// sequential output order. index answers every target in QUERYFILE from a reachable-sums index.
+// Built with -DSEARCH_STATS, each enumeration also writes a JSON line of search counters to stderr.
+int main(int argc, char *argv[]) {
+    int n;
+    long long targetSum;
+    enum SubsetMode mode = MODE_PRINT_ALL;
+    long long k = 0;
+    int decideOnly = 0, threads = 1, ordered = 0;
+
+    if (argc > 3 && strcmp(argv[1], "index") == 0)
+        return runIndexBatch(argv[2], argv[3], argc > 4 && strcmp(argv[4], "witness") == 0);
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "bench") == 0) {
+            benchmarkSubsets();
+            benchmarkEngines();
+            benchmarkParallel();
+            benchmarkIndex();
+            return 0;
+        } else if (strcmp(argv[a], "count") == 0) {
+            mode = MODE_COUNT;
+        } else if (strcmp(argv[a], "first") == 0 && a + 1 < argc) {
+            mode = MODE_FIRST_K;
+            k = atoll(argv[++a]);
+            if (k < 1) {
+                fprintf(stderr, "first needs K >= 1\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "solve") == 0) {
+            decideOnly = 1;
+        } else if (strcmp(argv[a], "threads") == 0 && a + 1 < argc) {
+            threads = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "ordered") == 0) {
+            ordered = 1;
+        }
+    }
 
     // Input the number of elements in the set
     printf("Enter the number of elements in the set: ");
-    scanf("%d", &n);
+    if (scanf("%d", &n) != 1 || n < 0)
+        return 1;
+    int *set = malloc((n > 0 ? n : 1) * sizeof(int));
 
-    // Input the elements of the set
+    // Input the elements of the set; every engine and the pruning bounds assume non-negative elements
     printf("Enter the elements of the set:\n");
     for (int i = 0; i < n; i++) {
-        scanf("%d", &set[i]);
+        if (scanf("%d", &set[i]) != 1 || set[i] < 0) {
+            fprintf(stderr, "Elements must be non-negative integers\n");
+            free(set);
+            return 1;
+        }
     }
 
     // Input the target sum
     printf("Enter the target sum: ");
-    scanf("%d", &targetSum);
+    scanf("%lld", &targetSum);
+
+    if (decideOnly) {
+        int *take = malloc((n > 0 ? n : 1) * sizeof(int));
+        enum SubsetEngine engine = chooseSubsetEngine(set, n, targetSum);
+        double start = wallTimeSeconds();
+        int found = solveSubsetSum(set, n, targetSum, engine, take);
+        double elapsed = wallTimeSeconds() - start;
+
+        printf("Engine: %s (%.4f s)\n", engineName(engine), elapsed);
+        if (found) {
+            printf("Subset that sums to %lld: { ", targetSum);
+            for (int i = 0; i < n; i++)
+                if (take[i])
+                    printf("%d ", set[i]);
+            printf("}\n");
+        } else {
+            printf("No solution found.\n");
+        }
+        free(take);
+        free(set);
+        return 0;
+    }
+
+    if (mode == MODE_COUNT)
+        printf("Counting subsets that sum to %lld\n", targetSum);
+    else
+        printf("Subsets that sum to %lld are:\n", targetSum);
+    fflush(stdout);
 
-    printf("Subsets that sum to %d are:\n", targetSum);
-    // Call the recursive function to find all subsets that sum to targetSum
-    sumOfSubsets(set, subset, n, 0, 0, 0, targetSum, &found);
+    BufferedWriter w;
+    writerInit(&w, stdout);
+    long long nodes;
+    double start = wallTimeSeconds();
+    long long found = (threads > 1)
+        ? parallelEnumerateSubsets(set, n, targetSum, mode, k, threads, ordered, stdout, &nodes)
+        : enumerateSubsets(set, n, targetSum, mode, k, &w, &nodes);
+    fflush(stdout);
+    double elapsed = wallTimeSeconds() - start;
+    STAT_REPORT(threads > 1 ? "parallelEnumerateSubsets" : "enumerateSubsets");
 
     // If no subset found, print a message
     if (!found) {
         printf("No solution found.\n");
+    } else {
+        printf("Solutions: %lld, Nodes visited: %lld (%.3g nodes/s)\n", found, nodes, elapsed > 0 ? nodes / elapsed : 0.0);
     }
 
+    free(w.buf);
+    free(set);
     return 0;
 }
\ No newline at end of file
@@ -1,23 +1,220 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 // Maximum function
 int max(int a, int b) { return (a > b) ? a : b; }
 
+//------------------------
+// Instrumentation
+//------------------------
+// Build with -DSEARCH_STATS to count what the solvers do. Without it every STAT_ macro expands to
+// nothing, so the default build runs exactly the uninstrumented code.
+#define STATS_LEVELS 64   // Level histogram buckets; deeper levels land in the last one
+#define STATS_QUEUE 32    // Queue length histogram, bucket k holds lengths in [2^k, 2^(k+1))
+
+enum stats_phase { PHASE_SETUP, PHASE_SEARCH, PHASE_COUNT };
+
+#ifdef SEARCH_STATS
+typedef struct {
+    long long expanded;
+    long long pruned_bound;       // Bound no better than the incumbent
+    long long pruned_infeasible;  // Item does not fit
+    long long peak_queue;
+    long long dp_cells;
+    long long level_histogram[STATS_LEVELS];
+    long long queue_histogram[STATS_QUEUE];
+    double phase_seconds[PHASE_COUNT];
+} search_stats;
+
+static search_stats stats;
+
+static double stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void stats_queue(long long length) {
+    int bucket = 0;
+    while (bucket < STATS_QUEUE - 1 && (2LL << bucket) <= length)
+        bucket++;
+    stats.queue_histogram[bucket]++;
+    if (length > stats.peak_queue)
+        stats.peak_queue = length;
+}
+
+static void trim_print(FILE *out, const char *name, const long long *values, int count) {
+    while (count > 1 && values[count - 1] == 0)
+        count--;
+    fprintf(out, ",\"%s\":[", name);
+    for (int i = 0; i < count; i++)
+        fprintf(out, i ? ",%lld" : "%lld", values[i]);
+    fprintf(out, "]");
+}
+
+// Function to write the counters of one solver call as one JSON line, then reset them
+static void stats_report(FILE *out, const char *solver) {
+    fprintf(out, "{\"solver\":\"%s\",\"expanded\":%lld,\"pruned_bound\":%lld,"
+            "\"pruned_infeasible\":%lld,\"peak_queue\":%lld,\"dp_cells\":%lld", solver, stats.expanded,
+            stats.pruned_bound, stats.pruned_infeasible, stats.peak_queue, stats.dp_cells);
+    trim_print(out, "level_histogram", stats.level_histogram, STATS_LEVELS);
+    trim_print(out, "queue_histogram", stats.queue_histogram, STATS_QUEUE);
+    fprintf(out, ",\"phase_seconds\":{\"setup\":%.6f,\"search\":%.6f}}\n",
+            stats.phase_seconds[PHASE_SETUP], stats.phase_seconds[PHASE_SEARCH]);
+    memset(&stats, 0, sizeof(stats));
+}
+
+#define STAT_INC(field) (stats.field++)
+#define STAT_ADD(field, amount) (stats.field += (amount))
+#define STAT_LEVEL(level) (stats.level_histogram[(level) < STATS_LEVELS ? (level) : STATS_LEVELS - 1]++)
+#define STAT_QUEUE(length) stats_queue(length)
+#define STAT_PHASE_BEGIN(phase) double stats_start_##phase = stats_now()
+#define STAT_PHASE_END(phase) (stats.phase_seconds[phase] += stats_now() - stats_start_##phase)
+#define STAT_RESET() memset(&stats, 0, sizeof(stats))
+#define STAT_REPORT(solver) stats_report(stderr, solver)
+// Runs one extra call of a timed solver on its own, so its counters describe a single call
+#define STAT_MEASURE(solver, call) do { STAT_RESET(); (void)(call); STAT_REPORT(solver); } while (0)
+#else
+#define STAT_INC(field) ((void)0)
+#define STAT_ADD(field, amount) ((void)0)
+#define STAT_LEVEL(level) ((void)0)
+#define STAT_QUEUE(length) ((void)0)
+#define STAT_PHASE_BEGIN(phase) ((void)0)
+#define STAT_PHASE_END(phase) ((void)0)
+#define STAT_RESET() ((void)0)
+#define STAT_REPORT(solver) ((void)0)
+#define STAT_MEASURE(solver, call) ((void)0)
+#endif
+
 //------------------------
 // Backtracking Approach
 //------------------------
+// (The level histogram counts calls by items left, n.)
 int knapsack_backtracking(int W, int wt[], int val[], int n) {
+    STAT_INC(expanded);
+    STAT_LEVEL(n);
     if (n == 0 || W == 0)
         return 0;
-    if (wt[n-1] > W)
+    if (wt[n-1] > W) {
+        STAT_INC(pruned_infeasible);
         return knapsack_backtracking(W, wt, val, n-1);
+    }
     else
         return max(val[n-1] + knapsack_backtracking(W - wt[n-1], wt, val, n-1),
                    knapsack_backtracking(W, wt, val, n-1));
 }
 
+//------------------------
+// Memoized Top-Down Approach
+//------------------------
+#define DENSE_MEMO_MAX_CELLS (1 << 24)  // Use a dense (n + 1) x (W + 1) table up to this many cells
+
+// Hash slot: key and value side by side so a probe touches one cache line
+typedef struct {
+    uint64_t key;
+    int value;
+} MemoEntry;
+
+// Memo for the (items left, remaining capacity) subproblems of knapsack_backtracking. Entries
+// store value + 1 so that 0 means "not computed": the dense table comes from calloc and only the
+// pages of reachable states are ever touched. Larger grids use open addressing with linear
+// probing on a 64-bit key (items << 32 | capacity), stored + 1 so that 0 marks an empty slot.
+typedef struct {
+    int *dense;
+    int width;              // W + 1 for the dense table
+    MemoEntry *slots;
+    size_t capacity;        // Hash slots, a power of two
+    size_t count;
+} MemoTable;
+
+long long memo_states = 0;  // Subproblems solved by the last knapsack_memoized run
+
+static size_t memo_slot(const MemoTable *t, uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key & (t->capacity - 1);
+}
+
+static int memo_get(const MemoTable *t, int n, int W) {
+    if (t->dense)
+        return t->dense[(size_t)n * t->width + W] - 1;
+    uint64_t key = ((uint64_t)n << 32 | (uint32_t)W) + 1;
+    for (size_t i = memo_slot(t, key); t->slots[i].key; i = (i + 1) & (t->capacity - 1))
+        if (t->slots[i].key == key)
+            return t->slots[i].value;
+    return -1;
+}
+
+static void memo_put(MemoTable *t, int n, int W, int value) {
+    memo_states++;
+    if (t->dense) {
+        t->dense[(size_t)n * t->width + W] = value + 1;
+        return;
+    }
+    // Keep the load factor at most 1/2
+    if (2 * (t->count + 1) > t->capacity) {
+        MemoTable grown = {NULL, 0, calloc(2 * t->capacity, sizeof(MemoEntry)), 2 * t->capacity, t->count};
+        for (size_t i = 0; i < t->capacity; i++) {
+            if (!t->slots[i].key)
+                continue;
+            size_t j = memo_slot(&grown, t->slots[i].key);
+            while (grown.slots[j].key)
+                j = (j + 1) & (grown.capacity - 1);
+            grown.slots[j] = t->slots[i];
+        }
+        free(t->slots);
+        *t = grown;
+    }
+    uint64_t key = ((uint64_t)n << 32 | (uint32_t)W) + 1;
+    size_t i = memo_slot(t, key);
+    while (t->slots[i].key)
+        i = (i + 1) & (t->capacity - 1);
+    t->slots[i] = (MemoEntry){key, value};
+    t->count++;
+}
+
+// Same recursion as knapsack_backtracking, but every (n, W) subproblem is solved once
+static int knapsack_memo_rec(MemoTable *t, int W, int wt[], int val[], int n) {
+    if (n == 0 || W == 0)
+        return 0;
+    int cached = memo_get(t, n, W);
+    if (cached >= 0)
+        return cached;
+    int result;
+    if (wt[n-1] > W)
+        result = knapsack_memo_rec(t, W, wt, val, n-1);
+    else
+        result = max(val[n-1] + knapsack_memo_rec(t, W - wt[n-1], wt, val, n-1),
+                     knapsack_memo_rec(t, W, wt, val, n-1));
+    memo_put(t, n, W, result);
+    return result;
+}
+
+// Top-down knapsack touching only the subproblems reachable from (n, W). memo_states gets
+// the number of subproblems solved, to compare with the n * W cells of knapsack_dp.
+int knapsack_memoized(int W, int wt[], int val[], int n) {
+    MemoTable t = {0};
+    memo_states = 0;
+    if (((long long)n + 1) * ((long long)W + 1) <= DENSE_MEMO_MAX_CELLS) {
+        t.width = W + 1;
+        t.dense = calloc((size_t)(n + 1) * t.width, sizeof(int));
+    } else {
+        t.capacity = 1024;
+        t.slots = calloc(t.capacity, sizeof(MemoEntry));
+    }
+    int result = knapsack_memo_rec(&t, W, wt, val, n);
+    free(t.dense);
+    free(t.slots);
+    return result;
+}
+
 //------------------------
 // Branch & Bound Approach
 //------------------------
@@ -47,8 +244,15 @@ float bound(Node u, int n, int W, int wt[], int val[]) {
     return profit_bound;
 }
 
+long long bb_nodes = 0;       // Nodes expanded by the last branch & bound run
+long long bb_node_limit = 0;  // Stop after this many expansions (0: no limit)
+int bb_limit_hit = 0;         // Set when the last run stopped at the limit; its result is then a lower bound
+
+// FIFO branch & bound over the items in the given order. The queue grows as needed.
 int knapsack_branch_and_bound(int W, int wt[], int val[], int n) {
-    Node queue[1000];
+    STAT_PHASE_BEGIN(PHASE_SETUP);
+    int capacity = 1024;
+    Node *queue = malloc(capacity * sizeof(Node));
     int front = 0, rear = 0;
     Node u, v;
     u.level = -1;
@@ -57,11 +261,33 @@ int knapsack_branch_and_bound(int W, int wt[], int val[], int n) {
     u.bound = bound(u, n, W, wt, val);
     queue[rear++] = u;
     int max_profit = 0;
+    bb_nodes = 0;
+    bb_limit_hit = 0;
+    STAT_PHASE_END(PHASE_SETUP);
+    STAT_PHASE_BEGIN(PHASE_SEARCH);
 
     while (front < rear) {
+        if (bb_node_limit && bb_nodes >= bb_node_limit) {
+            bb_limit_hit = 1;
+            break;
+        }
+        // Keep room for two children, sliding the live part of the queue down first
+        if (rear + 2 > capacity) {
+            memmove(queue, queue + front, (rear - front) * sizeof(Node));
+            rear -= front;
+            front = 0;
+            if (rear + 2 > capacity / 2) {
+                capacity *= 2;
+                queue = realloc(queue, capacity * sizeof(Node));
+            }
+        }
+        STAT_QUEUE(rear - front);
         u = queue[front++];
         if (u.level == n - 1)
             continue;
+        bb_nodes++;
+        STAT_INC(expanded);
+        STAT_LEVEL(u.level + 1);
         v.level = u.level + 1;
         
         // Taking the item
@@ -72,6 +298,10 @@ int knapsack_branch_and_bound(int W, int wt[], int val[], int n) {
             max_profit = v.profit;
         if (v.bound > max_profit)
             queue[rear++] = v;
+        else if (v.weight > W)
+            STAT_INC(pruned_infeasible);
+        else
+            STAT_INC(pruned_bound);
 
         // Not taking the item
         v.weight = u.weight;
@@ -79,32 +309,818 @@ int knapsack_branch_and_bound(int W, int wt[], int val[], int n) {
         v.bound = bound(v, n, W, wt, val);
         if (v.bound > max_profit)
             queue[rear++] = v;
+        else
+            STAT_INC(pruned_bound);
     }
 
+    free(queue);
+    STAT_PHASE_END(PHASE_SEARCH);
     return max_profit;
 }
 
+//------------------------
+// Best-First Branch & Bound
+//------------------------
+typedef struct {
+    int weight;
+    int value;
+    int index;  // Position in the caller's arrays
+} Item;
+
+// Node of the best-first search, kept in a growable pool so the path can be followed back
+typedef struct {
+    int level;       // Last sorted item decided
+    int profit;
+    int weight;
+    long long bound;
+    int parent;      // Pool index of the parent (-1 at the root)
+    int taken;       // Whether item `level` was taken
+} BBNode;
+
+// Context for one best-first run: items sorted by value/weight and their prefix sums.
+// Zero-weight items are always taken, so they are kept out of the search: items[n..n+free_count)
+// holds them and base_profit their total value.
+typedef struct {
+    Item *items;
+    long long *prefix_weight;  // prefix_weight[i] = weight of items 0..i-1
+    long long *prefix_value;
+    int n;                     // Items with positive weight, the ones searched
+    int free_count;
+    int base_profit;
+    int W;
+} BBProblem;
+
+int compare_ratio(const void *a, const void *b) {
+    const Item *x = (const Item *)a, *y = (const Item *)b;
+    // x before y when x.value / x.weight > y.value / y.weight
+    long long lhs = (long long)x->value * y->weight, rhs = (long long)y->value * x->weight;
+    return (lhs < rhs) - (lhs > rhs);
+}
+
+// Function to set the zero-weight items aside, sort the rest by value/weight and build the prefix
+// sums the bounds use. Without zero weights the ratio order is a consistent order for qsort and
+// the bounds never divide by zero.
+void bb_problem_init(BBProblem *p, int W, int wt[], int val[], int n) {
+    p->W = W;
+    p->items = malloc((n + 1) * sizeof(Item));
+    p->prefix_weight = malloc((n + 1) * sizeof(long long));
+    p->prefix_value = malloc((n + 1) * sizeof(long long));
+    p->n = 0;
+    p->free_count = 0;
+    p->base_profit = 0;
+    for (int i = 0; i < n; i++) {
+        if (wt[i] > 0) {
+            p->items[p->n++] = (Item){wt[i], val[i], i};
+        } else {
+            p->items[n - 1 - p->free_count++] = (Item){wt[i], val[i], i};
+            p->base_profit += val[i];
+        }
+    }
+    qsort(p->items, p->n, sizeof(Item), compare_ratio);
+    p->prefix_weight[0] = p->prefix_value[0] = 0;
+    for (int i = 0; i < p->n; i++) {
+        p->prefix_weight[i + 1] = p->prefix_weight[i] + p->items[i].weight;
+        p->prefix_value[i + 1] = p->prefix_value[i] + p->items[i].value;
+    }
+}
+
+// Function to mark the zero-weight items in the caller's selected[]
+static void bb_select_free_items(const BBProblem *p, int selected[]) {
+    for (int k = p->n; k < p->n + p->free_count; k++)
+        selected[p->items[k].index] = 1;
+}
+
+// Function to free what bb_problem_init allocated
+void bb_problem_free(BBProblem *p) {
+    free(p->items);
+    free(p->prefix_weight);
+    free(p->prefix_value);
+}
+
+// Function to compute an upper bound for a node whose items 0..level are decided. The greedy run of
+// whole items from level + 1 is found by binary search on the prefix weights, so the bound costs
+// O(log n); *fill gets one past the last whole item, which gives a feasible completion too. Rather
+// than the plain fractional bound this uses the Martello-Toth bound (never larger), in integers.
+long long bb_bound(const BBProblem *p, int level, int profit, int weight, int *fill) {
+    int start = level + 1;
+    long long room = p->W - weight;
+    if (room < 0) {
+        *fill = start;
+        return 0;
+    }
+    // Largest k with prefix_weight[k] - prefix_weight[start] <= room
+    int lo = start, hi = p->n;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (p->prefix_weight[mid] - p->prefix_weight[start] <= room)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    int k = lo;
+    *fill = k;
+    long long result = profit + p->prefix_value[k] - p->prefix_value[start];
+    if (k == p->n)
+        return result;
+
+    // Martello-Toth: branch on the critical item k instead of taking a fraction of it
+    long long left = room - (p->prefix_weight[k] - p->prefix_weight[start]);
+    const Item *c = &p->items[k];
+    long long without = result;
+    if (k + 1 < p->n)
+        without += left * p->items[k + 1].value / p->items[k + 1].weight;
+    long long with = -1;
+    if (k > start) {
+        // Make room for k by giving up weight at (at best) the ratio of item k - 1, rounding the loss up
+        const Item *prev = &p->items[k - 1];
+        with = result + c->value - ((c->weight - left) * prev->value + prev->weight - 1) / prev->weight;
+    }
+    return without > with ? without : with;
+}
+
+// Max-heap of pool indices keyed on bound
+static void bb_heap_push(int **heap, int *size, int *capacity, const BBNode *pool, int id) {
+    if (*size == *capacity) {
+        *capacity *= 2;
+        *heap = realloc(*heap, *capacity * sizeof(int));
+    }
+    int i = (*size)++;
+    while (i > 0 && pool[(*heap)[(i - 1) / 2]].bound < pool[id].bound) {
+        (*heap)[i] = (*heap)[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    (*heap)[i] = id;
+}
+
+static int bb_heap_pop(int *heap, int *size, const BBNode *pool) {
+    int top = heap[0];
+    int last = heap[--(*size)];
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= *size)
+            break;
+        if (c + 1 < *size && pool[heap[c + 1]].bound > pool[heap[c]].bound)
+            c++;
+        if (pool[heap[c]].bound <= pool[last].bound)
+            break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    if (*size > 0)
+        heap[i] = last;
+    return top;
+}
+
+// Best-first branch & bound: items are sorted by value/weight so the fractional bound is a true
+// upper bound, and the live node with the highest bound is expanded next. Every node's greedy
+// completion is a feasible solution, so the incumbent starts strong; the search ends as soon as
+// no live node can beat it. selected[i] is set to 1 for the chosen items (caller's indexing).
+int knapsack_best_first(int W, int wt[], int val[], int n, int selected[]) {
+    BBProblem p;
+    bb_problem_init(&p, W, wt, val, n);
+
+    int pool_capacity = 1024, pool_size = 0;
+    BBNode *pool = malloc(pool_capacity * sizeof(BBNode));
+    int heap_capacity = 1024, heap_size = 0;
+    int *heap = malloc(heap_capacity * sizeof(int));
+
+    // Incumbent: node best_node completed greedily with sorted items best_from..best_fill-1
+    int fill;
+    pool[pool_size++] = (BBNode){-1, 0, 0, bb_bound(&p, -1, 0, 0, &fill), -1, 0};
+    int best_profit = (int)(p.prefix_value[fill] - p.prefix_value[0]);
+    int best_node = 0, best_from = 0, best_fill = fill;
+    bb_heap_push(&heap, &heap_size, &heap_capacity, pool, 0);
+    bb_nodes = 0;
+    bb_limit_hit = 0;
+
+    while (heap_size > 0) {
+        int id = bb_heap_pop(heap, &heap_size, pool);
+        BBNode u = pool[id];
+        if (u.bound <= best_profit)
+            break;  // Highest bound left cannot improve: done
+        if (u.level == p.n - 1)
+            continue;
+        if (bb_node_limit && bb_nodes >= bb_node_limit) {
+            bb_limit_hit = 1;
+            break;
+        }
+        bb_nodes++;
+
+        int level = u.level + 1;
+        for (int take = 1; take >= 0; take--) {
+            int weight = u.weight + (take ? p.items[level].weight : 0);
+            int profit = u.profit + (take ? p.items[level].value : 0);
+            if (weight > W)
+                continue;
+            long long b = bb_bound(&p, level, profit, weight, &fill);
+            int greedy = profit + (int)(p.prefix_value[fill] - p.prefix_value[level + 1]);
+            if (b <= best_profit && greedy <= best_profit)
+                continue;
+
+            if (pool_size == pool_capacity) {
+                pool_capacity *= 2;
+                pool = realloc(pool, pool_capacity * sizeof(BBNode));
+            }
+            pool[pool_size] = (BBNode){level, profit, weight, b, id, take};
+            if (greedy > best_profit) {
+                best_profit = greedy;
+                best_node = pool_size;
+                best_from = level + 1;
+                best_fill = fill;
+            }
+            if (b > best_profit)
+                bb_heap_push(&heap, &heap_size, &heap_capacity, pool, pool_size);
+            pool_size++;
+        }
+    }
+
+    memset(selected, 0, n * sizeof(int));
+    for (int k = best_from; k < best_fill; k++)
+        selected[p.items[k].index] = 1;
+    for (int id = best_node; pool[id].parent >= 0; id = pool[id].parent)
+        if (pool[id].taken)
+            selected[p.items[pool[id].level].index] = 1;
+    bb_select_free_items(&p, selected);
+    best_profit += p.base_profit;
+
+    free(pool);
+    free(heap);
+    bb_problem_free(&p);
+    return best_profit;
+}
+
+//------------------------
+// Parallel Branch & Bound
+//------------------------
+#define PATH_BLOCK 4096  // Path links allocated per block by each worker
+
+// Taken item on a search path. Paths are shared between nodes and reference counted: a link is
+// held by its children, by every node whose path ends there and by the incumbent, and goes back to
+// a free list when the count drops to zero, so memory follows the live frontier, not the run time.
+typedef struct PathLink {
+    struct PathLink *parent;
+    int level;
+    atomic_int refs;
+} PathLink;
+
+// Subproblem: sorted items 0..level are decided, path lists the taken ones
+typedef struct {
+    int level;
+    int profit;
+    int weight;
+    long long bound;
+    PathLink *path;
+} PNode;
+
+// Deque of subproblems: the owner pushes and pops at the tail (depth first), thieves take from
+// the head where the shallowest, largest subtrees are
+typedef struct {
+    PNode *nodes;
+    int head, tail, capacity;
+    pthread_mutex_t lock;
+} PDeque;
+
+// Outcome of a parallel run
+typedef struct {
+    int profit;              // Best solution found
+    long long upper_bound;   // No solution is better than this
+    double gap;              // (upper_bound - profit) / upper_bound, 0 when proven optimal
+    long long nodes;         // Nodes expanded
+    int complete;            // 1 if the search finished, 0 if it stopped at the budget or time limit
+} BBResult;
+
+// Structure shared by the parallel branch & bound workers
+typedef struct {
+    BBProblem problem;
+    PDeque *deques;
+    int threads;
+    atomic_int best_profit;      // Incumbent value every worker prunes against
+    pthread_mutex_t best_lock;   // Guards the incumbent's solution below
+    PathLink *best_path;         // Incumbent = best_path plus sorted items best_from..best_fill-1
+    int best_from, best_fill;
+    atomic_long pending;         // Nodes pushed but not finished; 0 means the search is over
+    atomic_long nodes;
+    atomic_int stop;
+    atomic_llong open_bound;     // Largest bound of a node dropped because of stop
+    long long node_budget;
+    double deadline;
+} PState;
+
+typedef struct {
+    PState *state;
+    int id;
+    PathLink **blocks;           // Path link blocks owned by this worker
+    int block_count;
+    int used;                    // Links used in the last block
+    PathLink *free_links;        // Released links (from any block), chained through parent
+} PWorker;
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void atomic_max_ll(atomic_llong *target, long long value) {
+    long long seen = atomic_load(target);
+    while (value > seen && !atomic_compare_exchange_weak(target, &seen, value))
+        ;
+}
+
+static void pdeque_push(PDeque *q, PNode node) {
+    pthread_mutex_lock(&q->lock);
+    if (q->tail == q->capacity) {
+        if (q->head > q->capacity / 2) {
+            memmove(q->nodes, q->nodes + q->head, (q->tail - q->head) * sizeof(PNode));
+        } else {
+            q->capacity *= 2;
+            q->nodes = realloc(q->nodes, q->capacity * sizeof(PNode));
+            memmove(q->nodes, q->nodes + q->head, (q->tail - q->head) * sizeof(PNode));
+        }
+        q->tail -= q->head;
+        q->head = 0;
+    }
+    q->nodes[q->tail++] = node;
+    pthread_mutex_unlock(&q->lock);
+}
+
+// Function to take a node: from the tail of the worker's own deque, else from the head of another
+static int pdeque_take(PState *state, int id, PNode *node) {
+    for (int d = 0; d < state->threads; d++) {
+        PDeque *q = &state->deques[(id + d) % state->threads];
+        int got = 0;
+        pthread_mutex_lock(&q->lock);
+        if (q->head < q->tail) {
+            *node = (d == 0) ? q->nodes[--q->tail] : q->nodes[q->head++];
+            got = 1;
+        }
+        pthread_mutex_unlock(&q->lock);
+        if (got)
+            return 1;
+    }
+    return 0;
+}
+
+static void path_retain(PathLink *link) {
+    if (link)
+        atomic_fetch_add_explicit(&link->refs, 1, memory_order_relaxed);
+}
+
+// Function to drop one reference, recycling every link on the path that is no longer used
+static void path_release(PWorker *w, PathLink *link) {
+    while (link && atomic_fetch_sub(&link->refs, 1) == 1) {
+        PathLink *parent = link->parent;
+        link->parent = w->free_links;
+        w->free_links = link;
+        link = parent;
+    }
+}
+
+// Function to make a new link (holding one reference) for taking sorted item `level` after parent
+static PathLink *path_extend(PWorker *w, PathLink *parent, int level) {
+    PathLink *link = w->free_links;
+    if (link) {
+        w->free_links = link->parent;
+    } else {
+        if (w->block_count == 0 || w->used == PATH_BLOCK) {
+            w->blocks = realloc(w->blocks, (w->block_count + 1) * sizeof(PathLink *));
+            w->blocks[w->block_count++] = malloc(PATH_BLOCK * sizeof(PathLink));
+            w->used = 0;
+        }
+        link = &w->blocks[w->block_count - 1][w->used++];
+    }
+    path_retain(parent);
+    link->parent = parent;
+    link->level = level;
+    atomic_init(&link->refs, 1);
+    return link;
+}
+
+// Function to publish a feasible solution if it beats the incumbent
+static void offer_incumbent(PWorker *w, int profit, PathLink *path, int from, int fill) {
+    PState *state = w->state;
+    if (profit <= atomic_load_explicit(&state->best_profit, memory_order_relaxed))
+        return;
+    PathLink *replaced = NULL;
+    pthread_mutex_lock(&state->best_lock);
+    if (profit > atomic_load(&state->best_profit)) {
+        path_retain(path);
+        replaced = state->best_path;
+        state->best_path = path;
+        state->best_from = from;
+        state->best_fill = fill;
+        atomic_store(&state->best_profit, profit);
+    }
+    pthread_mutex_unlock(&state->best_lock);
+    path_release(w, replaced);
+}
+
+// Worker thread: depth-first on its own deque, stealing when it runs dry, until no node is pending
+static void *bb_worker(void *arg) {
+    PWorker *w = (PWorker *)arg;
+    PState *state = w->state;
+    const BBProblem *p = &state->problem;
+    PDeque *own = &state->deques[w->id];
+    long long local_nodes = 0;
+    PNode u;
+
+    while (atomic_load(&state->pending) > 0) {
+        if (!pdeque_take(state, w->id, &u)) {
+            sched_yield();
+            continue;
+        }
+        if (atomic_load_explicit(&state->stop, memory_order_relaxed)) {
+            if (u.bound > atomic_load(&state->best_profit))
+                atomic_max_ll(&state->open_bound, u.bound);
+            path_release(w, u.path);
+            atomic_fetch_sub(&state->pending, 1);
+            continue;
+        }
+        if (u.bound <= atomic_load_explicit(&state->best_profit, memory_order_relaxed) || u.level == p->n - 1) {
+            path_release(w, u.path);
+            atomic_fetch_sub(&state->pending, 1);
+            continue;
+        }
+
+        // Budget and clock are checked every 1024 local expansions
+        if (++local_nodes % 1024 == 0) {
+            long long total = atomic_fetch_add(&state->nodes, 1024) + 1024;
+            if ((state->node_budget && total >= state->node_budget) ||
+                (state->deadline > 0 && wall_seconds() >= state->deadline))
+                atomic_store(&state->stop, 1);
+        }
+
+        int level = u.level + 1;
+        // Skip child is pushed first so the take child is expanded next
+        for (int take = 0; take <= 1; take++) {
+            int weight = u.weight + (take ? p->items[level].weight : 0);
+            int profit = u.profit + (take ? p->items[level].value : 0);
+            if (weight > p->W)
+                continue;
+            int fill;
+            long long b = bb_bound(p, level, profit, weight, &fill);
+            PathLink *path = u.path;
+            if (take)
+                path = path_extend(w, u.path, level);
+            else
+                path_retain(path);
+            int greedy = profit + (int)(p->prefix_value[fill] - p->prefix_value[level + 1]);
+            offer_incumbent(w, greedy, path, level + 1, fill);
+            if (b > atomic_load_explicit(&state->best_profit, memory_order_relaxed)) {
+                atomic_fetch_add(&state->pending, 1);
+                pdeque_push(own, (PNode){level, profit, weight, b, path});
+            } else {
+                path_release(w, path);
+            }
+        }
+        path_release(w, u.path);
+        atomic_fetch_sub(&state->pending, 1);
+    }
+    atomic_fetch_add(&state->nodes, local_nodes % 1024);
+    return NULL;
+}
+
+// Parallel depth-first branch & bound on `threads` workers with work-stealing deques. Improvements
+// are published through an atomic incumbent, so every worker prunes with the latest value. With a
+// node budget (0: none) or a time limit in seconds (0: none) the search may stop early; the result
+// then carries the best solution so far, an upper bound from the nodes left open and the gap.
+BBResult knapsack_parallel_bb(int W, int wt[], int val[], int n, int selected[], int threads,
+                              long long node_budget, double time_limit) {
+    PState state;
+    bb_problem_init(&state.problem, W, wt, val, n);
+    if (threads < 1)
+        threads = 1;
+    state.threads = threads;
+    state.node_budget = node_budget;
+    state.deadline = time_limit > 0 ? wall_seconds() + time_limit : 0;
+    pthread_mutex_init(&state.best_lock, NULL);
+    atomic_init(&state.nodes, 0);
+    atomic_init(&state.stop, 0);
+    atomic_init(&state.open_bound, 0);
+    state.deques = malloc(threads * sizeof(PDeque));
+    for (int t = 0; t < threads; t++) {
+        state.deques[t].capacity = 1024;
+        state.deques[t].nodes = malloc(1024 * sizeof(PNode));
+        state.deques[t].head = state.deques[t].tail = 0;
+        pthread_mutex_init(&state.deques[t].lock, NULL);
+    }
+
+    int fill;
+    long long root_bound = bb_bound(&state.problem, -1, 0, 0, &fill);
+    atomic_init(&state.best_profit, (int)state.problem.prefix_value[fill]);
+    state.best_path = NULL;
+    state.best_from = 0;
+    state.best_fill = fill;
+    atomic_init(&state.pending, 1);
+    pdeque_push(&state.deques[0], (PNode){-1, 0, 0, root_bound, NULL});
+
+    pthread_t tids[threads];
+    PWorker workers[threads];
+    for (int t = 0; t < threads; t++)
+        workers[t] = (PWorker){&state, t, NULL, 0, 0, NULL};
+    // Workers only push to their own deque and steal from all, so if a thread cannot be created
+    // the search just runs on fewer workers (the caller always runs, and holds the root)
+    int started = 1;
+    while (started < threads && pthread_create(&tids[started], NULL, bb_worker, &workers[started]) == 0)
+        started++;
+    bb_worker(&workers[0]);
+    for (int t = 1; t < started; t++)
+        pthread_join(tids[t], NULL);
+
+    BBResult result;
+    result.profit = atomic_load(&state.best_profit);
+    result.nodes = atomic_load(&state.nodes);
+    result.complete = !atomic_load(&state.stop);
+    result.upper_bound = result.complete ? result.profit : atomic_load(&state.open_bound);
+    if (result.upper_bound < result.profit)
+        result.upper_bound = result.profit;
+    result.profit += state.problem.base_profit;
+    result.upper_bound += state.problem.base_profit;
+    result.gap = result.upper_bound > 0 ? (double)(result.upper_bound - result.profit) / result.upper_bound : 0;
+
+    memset(selected, 0, n * sizeof(int));
+    for (int k = state.best_from; k < state.best_fill; k++)
+        selected[state.problem.items[k].index] = 1;
+    for (const PathLink *link = state.best_path; link; link = link->parent)
+        selected[state.problem.items[link->level].index] = 1;
+    bb_select_free_items(&state.problem, selected);
+
+    for (int t = 0; t < threads; t++) {
+        for (int b = 0; b < workers[t].block_count; b++)
+            free(workers[t].blocks[b]);
+        free(workers[t].blocks);
+        pthread_mutex_destroy(&state.deques[t].lock);
+        free(state.deques[t].nodes);
+    }
+    free(state.deques);
+    pthread_mutex_destroy(&state.best_lock);
+    bb_problem_free(&state.problem);
+    return result;
+}
+
 //------------------------
 // Dynamic Programming Approach
 //------------------------
+// Greatest common divisor of two weights
+int gcd(int a, int b) {
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// A single row dp[w] is updated in reverse for each item, so memory is O(W) and lives on the heap.
+// Every subset weighs a multiple of the weights' GCD, so weights and capacity are divided by it first.
 int knapsack_dp(int W, int wt[], int val[], int n) {
-    int dp[n+1][W+1];
-    for (int i = 0; i <= n; i++) {
-        for (int w = 0; w <= W; w++) {
-            if (i == 0 || w == 0)
-                dp[i][w] = 0;
-            else if (wt[i-1] <= w)
-                dp[i][w] = max(val[i-1] + dp[i-1][w - wt[i-1]], dp[i-1][w]);
-            else
-                dp[i][w] = dp[i-1][w];
+    STAT_PHASE_BEGIN(PHASE_SETUP);
+    int g = 0;
+    for (int i = 0; i < n; i++)
+        g = gcd(g, wt[i]);
+    if (g <= 0)
+        g = 1;
+    W /= g;
+
+    int *dp = calloc(W + 1, sizeof(int));
+    STAT_PHASE_END(PHASE_SETUP);
+    STAT_PHASE_BEGIN(PHASE_SEARCH);
+    for (int i = 0; i < n; i++) {
+        int w_i = wt[i] / g;
+        for (int w = W; w >= w_i; w--)
+            dp[w] = max(val[i] + dp[w - w_i], dp[w]);
+        // Cells written by this item's row update
+        STAT_ADD(dp_cells, W >= w_i ? W - w_i + 1 : 0);
+    }
+    STAT_PHASE_END(PHASE_SEARCH);
+    int result = dp[W];
+    free(dp);
+    return result;
+}
+
+//------------------------
+// Memoization Benchmark
+//------------------------
+long long backtracking_calls = 0;
+
+// knapsack_backtracking with a call counter, to report how many subproblems it really solves
+int knapsack_backtracking_counted(int W, int wt[], int val[], int n) {
+    backtracking_calls++;
+    if (n == 0 || W == 0)
+        return 0;
+    if (wt[n-1] > W)
+        return knapsack_backtracking_counted(W, wt, val, n-1);
+    return max(val[n-1] + knapsack_backtracking_counted(W - wt[n-1], wt, val, n-1),
+               knapsack_backtracking_counted(W, wt, val, n-1));
+}
+
+// Function to compare the plain recursion, the memoized recursion and the bottom-up DP.
+// Recursion is only run for n <= 26; "-" marks skipped runs. The last two instances have a
+// large capacity, where the memo only visits a small part of the n * W grid.
+void benchmark_memoized() {
+    struct { int n; int max_weight; int capacity_divisor; } cases[] = {
+        {20, 100, 2}, {26, 100, 2}, {200, 1000, 4}, {22, 1000000, 2}
+    };
+    srand(7);
+    printf("\nn\tW\t\tRecursion calls\tms\tMemo states\tms\tDP cells\tms\tResults\n");
+
+    for (int c = 0; c < 4; c++) {
+        int n = cases[c].n;
+        int *wt = malloc(n * sizeof(int)), *val = malloc(n * sizeof(int));
+        long long total = 0;
+        for (int i = 0; i < n; i++) {
+            wt[i] = 1 + rand() % cases[c].max_weight;
+            val[i] = 1 + rand() % 1000;
+            total += wt[i];
+        }
+        int W = (int)(total / cases[c].capacity_divisor);
+        printf("%d\t%-9d\t", n, W);
+
+        int plain = -1;
+        if (n <= 26) {
+            backtracking_calls = 0;
+            clock_t start = clock();
+            plain = knapsack_backtracking_counted(W, wt, val, n);
+            printf("%lld\t%.1f\t", backtracking_calls, (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+        } else {
+            printf("-\t\t-\t");
+        }
+
+        clock_t start = clock();
+        int memoized = knapsack_memoized(W, wt, val, n);
+        printf("%lld\t\t%.1f\t", memo_states, (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+
+        start = clock();
+        int dp = knapsack_dp(W, wt, val, n);
+        printf("%lld\t%.1f\t", (long long)n * W, (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+        printf("%s\n", (memoized == dp && (plain < 0 || plain == dp)) ? "agree" : "MISMATCH");
+        free(wt);
+        free(val);
+    }
+}
+
+//------------------------
+// Branch & Bound Benchmark
+//------------------------
+// Correlated instance with capacity half the total weight. Weakly correlated: value = weight plus
+// noise within range / 10; strongly correlated: value = weight + range / 10. The value/weight ratios
+// are all close, which makes the bounds weak; the strong kind is the classic hard case for B&B.
+void make_correlated_instance(int n, int range, int strong, int wt[], int val[], int *W) {
+    long long total = 0;
+    for (int i = 0; i < n; i++) {
+        wt[i] = 1 + rand() % range;
+        if (strong)
+            val[i] = wt[i] + range / 10;
+        else
+            val[i] = max(1, wt[i] - range / 10 + rand() % (range / 5 + 1));
+        total += wt[i];
+    }
+    *W = (int)(total / 2);
+}
+
+// Function to compare FIFO branch & bound (in input order and in ratio order) with best-first
+// branch & bound on correlated instances. Each run may expand at most BB_BENCH_LIMIT nodes; a run
+// that stops there is marked with '*' and its value is only a lower bound. DP gives the optimum.
+#define BB_BENCH_LIMIT 2000000
+void benchmark_branch_and_bound() {
+    int sizes[] = {100, 200, 500, 1000};
+    srand(2024);
+    printf("\nCorrelated instances (range 1000), node limit %d\n", BB_BENCH_LIMIT);
+    printf("Kind\tn\tOptimum\tFIFO\tNodes\tms\tFIFO sorted\tNodes\tms\tBest-first\tNodes\tms\n");
+
+    for (int strong = 0; strong <= 1; strong++) {
+        for (int s = 0; s < 4; s++) {
+            int n = sizes[s], W;
+            int *wt = malloc(n * sizeof(int)), *val = malloc(n * sizeof(int));
+            int *selected = malloc(n * sizeof(int));
+            make_correlated_instance(n, 1000, strong, wt, val, &W);
+            int optimum = knapsack_dp(W, wt, val, n);
+            bb_node_limit = BB_BENCH_LIMIT;
+
+            STAT_RESET();
+            clock_t start = clock();
+            int fifo = knapsack_branch_and_bound(W, wt, val, n);
+            double fifo_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+            STAT_REPORT("knapsack_branch_and_bound");
+            long long fifo_nodes = bb_nodes;
+            int fifo_limit = bb_limit_hit;
+
+            // Same FIFO search on ratio-sorted copies, so its bound is valid
+            Item *items = malloc(n * sizeof(Item));
+            int *swt = malloc(n * sizeof(int)), *sval = malloc(n * sizeof(int));
+            for (int i = 0; i < n; i++)
+                items[i] = (Item){wt[i], val[i], i};
+            qsort(items, n, sizeof(Item), compare_ratio);
+            for (int i = 0; i < n; i++) {
+                swt[i] = items[i].weight;
+                sval[i] = items[i].value;
+            }
+            start = clock();
+            int sorted_fifo = knapsack_branch_and_bound(W, swt, sval, n);
+            double sorted_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+            long long sorted_nodes = bb_nodes;
+            int sorted_limit = bb_limit_hit;
+
+            start = clock();
+            int best = knapsack_best_first(W, wt, val, n, selected);
+            double best_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC;
+            int best_limit = bb_limit_hit;
+            long long check_weight = 0, check_value = 0;
+            for (int i = 0; i < n; i++) {
+                if (selected[i]) {
+                    check_weight += wt[i];
+                    check_value += val[i];
+                }
+            }
+
+            printf("%s\t%d\t%d\t%d%s\t%lld\t%.1f\t%d%s\t\t%lld\t%.1f\t%d%s\t\t%lld\t%.1f%s\n",
+                   strong ? "strong" : "weak", n, optimum,
+                   fifo, fifo_limit ? "*" : "", fifo_nodes, fifo_ms,
+                   sorted_fifo, sorted_limit ? "*" : "", sorted_nodes, sorted_ms,
+                   best, best_limit ? "*" : "", bb_nodes, best_ms,
+                   (check_value == best && check_weight <= W) ? "" : "  (bad selection)");
+            bb_node_limit = 0;
+            free(items);
+            free(swt);
+            free(sval);
+            free(wt);
+            free(val);
+            free(selected);
+        }
+    }
+
+    // Zero-weight items (some also worth nothing) are taken up front by both branch & bound solvers
+    int zero_mismatches = 0;
+    int zwt[] = {0, 5}, zval[] = {1, 3}, zselected[16];
+    zero_mismatches += knapsack_best_first(3, zwt, zval, 2, zselected) != knapsack_dp(3, zwt, zval, 2);
+    for (int t = 0; t < 500; t++) {
+        int n = 1 + rand() % 16, W = rand() % 60;
+        int wt[16], val[16];
+        for (int i = 0; i < n; i++) {
+            wt[i] = rand() % 3 == 0 ? 0 : 1 + rand() % 20;
+            val[i] = rand() % 10;
+        }
+        int optimum = knapsack_dp(W, wt, val, n);
+        int best = knapsack_best_first(W, wt, val, n, zselected);
+        long long check_weight = 0, check_value = 0;
+        for (int i = 0; i < n; i++) {
+            if (zselected[i]) {
+                check_weight += wt[i];
+                check_value += val[i];
+            }
+        }
+        BBResult r = knapsack_parallel_bb(W, wt, val, n, zselected, 1 + t % 2, 0, 0);
+        long long parallel_value = 0;
+        for (int i = 0; i < n; i++)
+            parallel_value += zselected[i] ? val[i] : 0;
+        zero_mismatches += best != optimum || check_value != best || check_weight > W
+                        || r.profit != optimum || parallel_value != optimum;
+    }
+    printf("Zero-weight items: 501 instances, %d mismatches\n", zero_mismatches);
+}
+
+// Function to run the parallel branch & bound with a time limit on 1, 2 and all online threads.
+// The proven upper bound must not be below the DP optimum, and gap is relative to that bound.
+#define PARALLEL_BB_SECONDS 0.5
+void benchmark_parallel_bb() {
+    int sizes[] = {100, 500, 1000};
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int thread_counts[] = {1, 2, max_threads > 2 ? max_threads : 4};
+    srand(4048);
+    printf("\nParallel branch & bound, time limit %.1f s, %d CPUs online\n", PARALLEL_BB_SECONDS, max_threads);
+    printf("Kind\tn\tOptimum\tThreads\tProfit\tUpper\tGap\t\tNodes\t\tms\tDone\n");
+
+    for (int strong = 0; strong <= 1; strong++) {
+        for (int s = 0; s < 3; s++) {
+            int n = sizes[s], W;
+            int *wt = malloc(n * sizeof(int)), *val = malloc(n * sizeof(int));
+            int *selected = malloc(n * sizeof(int));
+            make_correlated_instance(n, 1000, strong, wt, val, &W);
+            int optimum = knapsack_dp(W, wt, val, n);
+
+            for (int t = 0; t < 3; t++) {
+                double start = wall_seconds();
+                BBResult r = knapsack_parallel_bb(W, wt, val, n, selected, thread_counts[t], 0, PARALLEL_BB_SECONDS);
+                double ms = (wall_seconds() - start) * 1000;
+                long long check = 0;
+                for (int i = 0; i < n; i++)
+                    check += selected[i] ? val[i] : 0;
+                printf("%s\t%d\t%d\t%d\t%d\t%lld\t%.2e\t%lld\t\t%.1f\t%s%s\n", strong ? "strong" : "weak", n, optimum,
+                       thread_counts[t], r.profit, r.upper_bound, r.gap, r.nodes, ms, r.complete ? "yes" : "no",
+                       (check == r.profit && r.upper_bound >= optimum) ? "" : "  (inconsistent)");
+            }
+            free(wt);
+            free(val);
+            free(selected);
         }
     }
-    return dp[n][W];
 }
 
 //------------------------
 // Main function to test all approaches
 //------------------------
+// Built with -DSEARCH_STATS, each approach also writes a JSON line of solver counters to stderr
 int main() {
     int val[] = {240, 400, 480, 560, 600, 800};
     int wt[] = {40, 80, 120, 160, 200, 240};
@@ -121,6 +1137,17 @@ int main() {
     clock_t end = clock();
     printf("Backtracking Result: %d, Time: %lf ms\n", result_backtracking, 
            (double)(end - start) * 1000 / (CLOCKS_PER_SEC * repetitions));
+    STAT_MEASURE("knapsack_backtracking", knapsack_backtracking(W, wt, val, n));
+
+    // Memoized Top-Down Approach
+    start = clock();
+    int result_memoized = 0;
+    for (int i = 0; i < repetitions; i++) {
+        result_memoized = knapsack_memoized(W, wt, val, n);
+    }
+    end = clock();
+    printf("Memoized Result: %d, Time: %lf ms, States: %lld\n", result_memoized,
+           (double)(end - start) * 1000 / (CLOCKS_PER_SEC * repetitions), memo_states);
 
     // Branch & Bound Approach
     start = clock();
@@ -131,6 +1158,7 @@ int main() {
     end = clock();
     printf("Branch & Bound Result: %d, Time: %lf ms\n", result_branch_bound, 
            (double)(end - start) * 1000 / (CLOCKS_PER_SEC * repetitions));
+    STAT_MEASURE("knapsack_branch_and_bound", knapsack_branch_and_bound(W, wt, val, n));
 
     // Dynamic Programming Approach
     start = clock();
@@ -141,6 +1169,27 @@ int main() {
     end = clock();
     printf("Dynamic Programming Result: %d, Time: %lf ms\n", result_dp, 
            (double)(end - start) * 1000 / (CLOCKS_PER_SEC * repetitions));
+    STAT_MEASURE("knapsack_dp", knapsack_dp(W, wt, val, n));
+
+    // Best-First Branch & Bound
+    int selected[6];
+    start = clock();
+    int result_best_first = 0;
+    for (int i = 0; i < repetitions; i++) {
+        result_best_first = knapsack_best_first(W, wt, val, n, selected);
+    }
+    end = clock();
+    printf("Best-First Branch & Bound Result: %d, Time: %lf ms, Items:", result_best_first,
+           (double)(end - start) * 1000 / (CLOCKS_PER_SEC * repetitions));
+    for (int i = 0; i < n; i++) {
+        if (selected[i])
+            printf(" %d", i);
+    }
+    printf("\n");
+
+    benchmark_memoized();
+    benchmark_branch_and_bound();
+    benchmark_parallel_bb();
 
     return 0;
 }
\ No newline at end of file